@@ -0,0 +1,51 @@
+#include "allocation_counter.hpp"
+
+#ifdef TETRIS_COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<uint64_t> allocation_count{ 0 };
+}
+
+// operator new[] AND THE nothrow OVERLOADS FORWARD HERE BY DEFAULT
+void* operator new(std::size_t size)
+{
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+	if (auto memory = std::malloc(size == 0 ? 1 : size))
+		return memory;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+#endif
+
+bool allocation_counter::is_enabled()
+{
+#ifdef TETRIS_COUNT_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+uint64_t allocation_counter::get_count()
+{
+#ifdef TETRIS_COUNT_ALLOCATIONS
+	return allocation_count.load(std::memory_order_relaxed);
+#else
+	return 0;
+#endif
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include <cstdint>
+
+// COUNTS CALLS TO THE GLOBAL operator new
+// THE HOOK IS ONLY COMPILED IN WITH TETRIS_COUNT_ALLOCATIONS, OTHERWISE get_count STAYS 0
+namespace allocation_counter
+{
+	bool is_enabled();
+	uint64_t get_count();
+}
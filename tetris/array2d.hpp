@@ -1,25 +1,57 @@
 #pragma once
 #include <vector>
 #include <algorithm>
+#include <cstdint>
 
+// NON-OWNING VIEW OF ONE ROW OF AN array2d
+template <typename T>
+struct array2d_row
+{
+	array2d_row(T* row_data, size_t row_size) : elements(row_data), size_of_row(row_size) {}
+
+	// ASSIGNING A VIEW WOULD ONLY REBIND IT, USE array2d::copy_rows TO COPY CONTENTS
+	array2d_row& operator=(const array2d_row&) = delete;
+
+	inline auto operator[] (const size_t index) -> T&
+	{
+		return this->elements[index];
+	}
+
+	inline auto begin() -> T*
+	{
+		return this->elements;
+	}
+	inline auto end() -> T*
+	{
+		return this->elements + this->size_of_row;
+	}
+
+	inline auto size() -> size_t
+	{
+		return this->size_of_row;
+	}
+
+private:
+	T* elements;
+	size_t size_of_row;
+};
+
+// ROWS ARE STORED BACK TO BACK IN ONE BUFFER, ROW x STARTS AT x * stride
 template <typename T>
 struct array2d
 {
 	array2d() = default;
-	array2d(size_t x, size_t y) : count_of_row(x), size_of_row(y), data(count_of_row)
+	array2d(size_t x, size_t y) : count_of_row(x), size_of_row(y), stride(y), data(count_of_row * stride)
 	{
-		std::for_each(data.begin(), data.end(), [=](auto& row) {
-			row.resize(size_of_row);
-		});
 	}
 
 	auto get_element(size_t x_index, size_t y_index) -> T&
 	{
-		return this->data[x_index][y_index];
+		return this->data[x_index * this->stride + y_index];
 	}
-	auto get_row(int32_t x_index) -> std::vector<T>&
+	auto get_row(int32_t x_index) -> array2d_row<T>
 	{
-		return this->data[x_index];
+		return array2d_row<T>(this->get_data() + x_index * this->stride, this->size_of_row);
 	}
 
 	auto get_row_count() -> size_t
@@ -30,9 +62,55 @@ struct array2d
 	{
 		return this->size_of_row;
 	}
+	auto get_stride() -> size_t
+	{
+		return this->stride;
+	}
+	auto get_data() -> T*
+	{
+		return this->data.data();
+	}
+
+	// SET EVERY ELEMENT
+	void fill(const T& value)
+	{
+		std::fill(this->data.begin(), this->data.end(), value);
+	}
+	void fill_row(size_t x_index, const T& value)
+	{
+		auto row = this->get_row(x_index);
+		std::fill(row.begin(), row.end(), value);
+	}
+
+	// COPY count ROWS STARTING AT source TO destination, RANGES MAY OVERLAP
+	// ROWS ARE CONTIGUOUS SO THIS IS A SINGLE MEMMOVE FOR TRIVIAL TYPES
+	void copy_rows(size_t destination, size_t source, size_t count)
+	{
+		const auto source_begin = this->data.begin() + source * this->stride;
+		const auto source_end = source_begin + count * this->stride;
+		const auto destination_begin = this->data.begin() + destination * this->stride;
+
+		if (destination > source)
+			std::copy_backward(source_begin, source_end, destination_begin + count * this->stride);
+		else
+			std::copy(source_begin, source_end, destination_begin);
+	}
+
+	// COPY count ELEMENTS OF ROW x_index STARTING AT COLUMN y_index FROM AN ARRAY OF SAME DIMENSIONS
+	void copy_range(array2d& source, size_t x_index, size_t y_index, size_t count)
+	{
+		const auto offset = x_index * this->stride + y_index;
+		std::copy(source.data.begin() + offset, source.data.begin() + offset + count, this->data.begin() + offset);
+	}
+
+	bool operator==(const array2d& other) const
+	{
+		return this->count_of_row == other.count_of_row && this->size_of_row == other.size_of_row && this->data == other.data;
+	}
 
 private:
-	size_t count_of_row;
-	size_t size_of_row;
-	std::vector<std::vector<T>> data;
+	size_t count_of_row = 0;
+	size_t size_of_row = 0;
+	size_t stride = 0;
+	std::vector<T> data;
 };
\ No newline at end of file
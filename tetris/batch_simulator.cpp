@@ -0,0 +1,181 @@
+#include "batch_simulator.hpp"
+#include <algorithm>
+#include <functional>
+
+void batch_report::add(const game_result& result)
+{
+	++this->games;
+	this->capped_games += result.capped;
+	this->total_score += result.score;
+	this->total_lines += result.lines;
+	this->total_pieces += result.pieces;
+	this->total_ticks += result.ticks;
+	this->min_score = std::min(this->min_score, result.score);
+	this->max_score = std::max(this->max_score, result.score);
+}
+
+void batch_report::merge(const batch_report& other)
+{
+	this->games += other.games;
+	this->capped_games += other.capped_games;
+	this->total_score += other.total_score;
+	this->total_lines += other.total_lines;
+	this->total_pieces += other.total_pieces;
+	this->total_ticks += other.total_ticks;
+	this->min_score = std::min(this->min_score, other.min_score);
+	this->max_score = std::max(this->max_score, other.max_score);
+	this->steals += other.steals;
+}
+
+batch_simulator::batch_simulator(const batch_settings& settings) : settings(settings)
+{
+	if (this->settings.threads == 0)
+		this->settings.threads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+batch_report batch_simulator::run()
+{
+	const auto threads = this->settings.threads;
+
+	if (this->settings.width > board_shape::max_width)
+	{
+		batch_report rejected;
+		rejected.board_too_wide = true;
+		return rejected;
+	}
+
+	// EQUAL SLICES, THE FIRST games % threads WORKERS GET ONE EXTRA
+	this->queues = std::vector<work_queue>(threads);
+	uint64_t first = 0;
+	for (uint32_t worker = 0; worker < threads; worker++)
+	{
+		const auto count = this->settings.games / threads + (worker < this->settings.games % threads ? 1 : 0);
+		this->queues[worker].next = first;
+		this->queues[worker].end = first + count;
+		first += count;
+	}
+
+	// EVERY WORKER FILLS ITS OWN REPORT, THEY ARE ONLY MERGED ONCE ALL ARE DONE
+	std::vector<batch_report> reports(threads);
+	std::vector<std::thread> workers;
+	for (uint32_t worker = 1; worker < threads; worker++)
+		workers.emplace_back(&batch_simulator::work, this, worker, std::ref(reports[worker]));
+
+	this->work(0, reports[0]);
+
+	for (auto& thread : workers)
+		thread.join();
+
+	batch_report total;
+	for (auto& report : reports)
+	{
+		total.merge(report);
+		total.games_per_thread.push_back(report.games);
+	}
+
+	return total;
+}
+
+batch_settings& batch_simulator::get_settings()
+{
+	return this->settings;
+}
+
+game_result batch_simulator::play_game(const batch_settings& settings, const uint64_t seed, placement_bot& bot)
+{
+	auto engine = tetris_engine(settings.width, settings.height, seed);
+	engine.start();
+	bot.reset();
+
+	auto result = game_result{ seed, 0, 0, 0, 0, false };
+	while (true)
+	{
+		const auto step = bot.step(engine);
+		result.lines += step.lines_cleared;
+		result.pieces += step.locked;
+
+		if (step.game_over)
+			break;
+
+		if (engine.get_tick() >= settings.tick_limit)
+		{
+			result.capped = true;
+			break;
+		}
+	}
+
+	result.score = engine.get_score();
+	result.ticks = engine.get_tick();
+	return result;
+}
+
+void batch_simulator::work(const uint32_t worker, batch_report& report)
+{
+	// ONE BOT PER WORKER, ITS BUFFERS ARE REUSED FOR EVERY GAME
+	auto bot = placement_bot();
+	uint64_t game = 0;
+
+	while (true)
+	{
+		if (!this->take(worker, game))
+		{
+			if (!this->steal(worker, game))
+				return;
+
+			++report.steals;
+		}
+
+		report.add(play_game(this->settings, this->settings.first_seed + game, bot));
+	}
+}
+
+bool batch_simulator::take(const uint32_t worker, uint64_t& game)
+{
+	auto& queue = this->queues[worker];
+	std::lock_guard<std::mutex> guard(queue.lock);
+
+	if (queue.next == queue.end)
+		return false;
+
+	game = queue.next++;
+	return true;
+}
+
+bool batch_simulator::steal(const uint32_t thief, uint64_t& game)
+{
+	const auto threads = static_cast<uint32_t>(this->queues.size());
+
+	// VISIT THE OTHERS STARTING FROM THE NEXT WORKER, SO THIEVES SPREAD OUT
+	for (uint32_t offset = 1; offset < threads; offset++)
+	{
+		auto& victim = this->queues[(thief + offset) % threads];
+
+		uint64_t first = 0;
+		uint64_t end = 0;
+		{
+			std::lock_guard<std::mutex> guard(victim.lock);
+
+			const auto remaining = victim.end - victim.next;
+			if (remaining == 0)
+				continue;
+
+			// TAKE THE BACK HALF, ROUNDED UP SO A SINGLE GAME CAN BE STOLEN TOO
+			first = victim.end - (remaining + 1) / 2;
+			end = victim.end;
+			victim.end = first;
+		}
+
+		// RUN THE FIRST STOLEN GAME NOW, QUEUE THE REST AS OUR OWN SO OTHERS CAN STEAL THEM BACK
+		auto& queue = this->queues[thief];
+		{
+			std::lock_guard<std::mutex> guard(queue.lock);
+			queue.next = first + 1;
+			queue.end = end;
+		}
+
+		game = first;
+		return true;
+	}
+
+	return false;
+}
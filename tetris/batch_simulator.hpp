@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "placement_bot.hpp"
+#include "tetris_engine.hpp"
+
+// OUTCOME OF ONE SIMULATED GAME
+struct game_result
+{
+	uint64_t seed;
+	uint32_t score;
+	uint64_t lines;
+	uint64_t pieces;
+	uint64_t ticks;
+	bool capped;
+};
+
+// RESULTS OF MANY GAMES, MERGED AS GAMES FINISH
+struct batch_report
+{
+	uint64_t games = 0;
+	uint64_t capped_games = 0;
+	uint64_t total_score = 0;
+	uint64_t total_lines = 0;
+	uint64_t total_pieces = 0;
+	uint64_t total_ticks = 0;
+	uint32_t min_score = UINT32_MAX;
+	uint32_t max_score = 0;
+
+	// SLICES TAKEN FROM ANOTHER WORKER, AND GAMES EACH WORKER PLAYED
+	uint64_t steals = 0;
+	std::vector<uint64_t> games_per_thread;
+
+	// SET WHEN THE BATCH WAS REJECTED WITHOUT PLAYING, THE BOT ONLY SEARCHES UP TO board_shape::max_width COLUMNS
+	bool board_too_wide = false;
+
+	void add(const game_result& result);
+	void merge(const batch_report& other);
+};
+
+struct batch_settings
+{
+	// AT MOST board_shape::max_width, WIDER BATCHES ARE REJECTED WITH batch_report::board_too_wide
+	int32_t width = 14;
+	int32_t height = 20;
+
+	// GAME i IS SEEDED WITH first_seed + i, SO A BATCH IS THE SAME ON ANY AMOUNT OF THREADS
+	uint64_t first_seed = 0;
+	uint64_t games = 1'000;
+
+	// 0 MEANS ONE PER HARDWARE THREAD
+	uint32_t threads = 0;
+
+	// GAMES STILL RUNNING AFTER THIS MANY TICKS ARE STOPPED AND COUNTED AS CAPPED
+	uint64_t tick_limit = 1'000'000;
+};
+
+// PLAYS A BATCH OF INDEPENDENT BOT GAMES ON ALL CORES
+// EVERY WORKER STARTS WITH AN EQUAL SLICE OF THE GAMES, GAME LENGTHS VARY A LOT
+// SO A WORKER THAT RUNS OUT STEALS HALF OF THE REMAINING SLICE OF ANOTHER ONE
+class batch_simulator
+{
+public:
+	batch_simulator(const batch_settings& settings);
+
+	batch_report run();
+
+	// AS GIVEN, WITH threads FILLED IN
+	batch_settings& get_settings();
+
+	// ONE GAME FROM START TO GAME OVER OR tick_limit
+	static game_result play_game(const batch_settings& settings, const uint64_t seed, placement_bot& bot);
+
+private:
+	// GAMES [next, end) NOT YET STARTED BY A WORKER, PADDED TO A CACHE LINE
+	// SO WORKERS TAKING THEIR OWN GAMES DON'T SHARE LINES
+	struct alignas(64) work_queue
+	{
+		std::mutex lock;
+		uint64_t next = 0;
+		uint64_t end = 0;
+	};
+
+	void work(const uint32_t worker, batch_report& report);
+	bool take(const uint32_t worker, uint64_t& game);
+	bool steal(const uint32_t thief, uint64_t& game);
+
+	batch_settings settings;
+	std::vector<work_queue> queues;
+};
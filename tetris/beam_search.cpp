@@ -0,0 +1,272 @@
+#include "beam_search.hpp"
+#include <algorithm>
+#include <limits>
+
+beam_search::beam_search(const beam_settings& settings) :
+	settings(settings), statistics(), plan(), has_plan(false), current_layer(0), depth(0), queue(), shape(0, 0)
+{
+}
+
+step_result beam_search::step(tetris_engine& engine)
+{
+	if (!this->has_plan)
+	{
+		this->plan = this->search(engine);
+		this->has_plan = true;
+	}
+
+	// HOLD ON THE FIRST TICK, THE PLACEMENT IS FOR THE PIECE THAT COMES OUT OF IT
+	auto input = input_none;
+	if (this->plan.hold)
+	{
+		this->plan.hold = false;
+		input = input_hold;
+	}
+	else
+		input = static_cast<input_action>(placement_search::steer(engine, this->plan.target));
+
+	const auto result = engine.step(input);
+
+	// NEXT PIECE NEEDS A NEW PLAN
+	if (result.locked || result.game_over)
+		this->has_plan = false;
+
+	return result;
+}
+
+void beam_search::reset()
+{
+	this->has_plan = false;
+}
+
+beam_move beam_search::search(tetris_engine& engine)
+{
+	const auto start_time = std::chrono::steady_clock::now();
+	++this->statistics.searches;
+
+	if (engine.get_border_width() > board_shape::max_width)
+		return beam_move{ false, placement_search::drop_in_place(engine) };
+
+	this->prepare(engine);
+
+	auto over_budget = false;
+	while (!over_budget)
+	{
+		this->candidates.clear();
+
+		auto& nodes = this->layers[this->current_layer];
+		for (uint32_t index = 0; index < nodes.size(); index++)
+		{
+			// CHECKED PER NODE, ONE NODE IS AT MOST A FEW DOZEN PLACEMENTS
+			if (std::chrono::steady_clock::now() - start_time > this->settings.time_budget)
+			{
+				over_budget = true;
+				++this->statistics.searches_over_budget;
+				break;
+			}
+
+			this->expand(index);
+		}
+
+		// ONLY SOME PARENTS WERE EXPANDED, THEIR CHILDREN WOULD WIN THE BEAM JUST FOR BEING FIRST
+		if (over_budget)
+			break;
+
+		// EVERY BOARD USED THE WHOLE QUEUE, OR NOTHING FITS
+		const auto any_placed = std::any_of(this->candidates.begin(), this->candidates.end(), [](const candidate& entry) { return entry.placed; });
+		if (!any_placed)
+			break;
+
+		this->build_next_depth();
+	}
+
+	// BEST BOARD OF THE DEEPEST COMPLETE DEPTH
+	auto& nodes = this->layers[this->current_layer];
+	const auto best = std::max_element(nodes.begin(), nodes.end(), [](const node& left, const node& right) { return left.score < right.score; });
+
+	this->statistics.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+
+	return best->first_move;
+}
+
+beam_statistics& beam_search::get_statistics()
+{
+	return this->statistics;
+}
+
+void beam_search::prepare(tetris_engine& engine)
+{
+	this->shape = board_shape(engine.get_border_width(), engine.get_border_height());
+	this->start_position = engine.get_start_position();
+	this->current_position = engine.get_current_piece().get_position();
+	this->queue = { engine.get_current_piece().get_piece(), engine.get_next_piece().get_piece() };
+
+	// SIZE THE POOLS, ONLY ALLOCATES ON THE FIRST SEARCH OR WHEN THE BOARD GROWS
+	const auto beam_width = this->settings.beam_width;
+	this->boards.resize(static_cast<size_t>(2) * beam_width * this->shape.get_row_count());
+	this->scratch.resize(this->shape.get_row_count());
+	for (auto& layer : this->layers)
+		layer.reserve(beam_width);
+	this->kept_keys.reserve(beam_width);
+
+	// EVERY ROTATION AND COLUMN OF TWO PIECES (WITH AND WITHOUT HOLD) PER NODE
+	this->candidates.reserve(static_cast<size_t>(beam_width) * 2 * tetromino_table::rotation_count * this->shape.get_width());
+
+	// ROOT: THE GAME AS IT IS, FALLBACK MOVE DROPS THE PIECE WHERE IT IS
+	this->current_layer = 0;
+	this->depth = 0;
+	placement_search::copy_rows(engine, this->get_board(0, 0));
+
+	auto& saved = engine.get_saved_piece();
+
+	auto root = node();
+	root.score = -std::numeric_limits<float>::infinity();
+	root.lines = 0;
+	root.hash = engine.get_board().get_hash();
+	root.queue_index = 0;
+	root.has_held = saved.valid();
+	root.can_hold = !engine.get_switched_piece();
+	root.held = saved.get_piece();
+	root.first_move = beam_move{ false, placement_search::drop_in_place(engine) };
+
+	this->layers[0].clear();
+	this->layers[0].push_back(root);
+}
+
+void beam_search::expand(const uint32_t parent)
+{
+	const auto& parent_node = this->layers[this->current_layer][parent];
+
+	// NOTHING LEFT TO PLACE, THE BOARD COMPETES AS IT IS
+	if (parent_node.queue_index >= queue_size)
+	{
+		this->candidates.push_back(candidate{ parent_node.score, this->get_key(parent_node), parent, false, tetromino(), 0, 0, parent_node });
+		return;
+	}
+
+	const auto active = this->queue[parent_node.queue_index];
+
+	// PLACE THE ACTIVE PIECE, ONLY THE PIECE IN PLAY MAY HAVE MOVED ALREADY
+	auto child = parent_node;
+	child.queue_index = parent_node.queue_index + 1;
+	child.can_hold = true;
+
+	auto position = this->depth == 0 ? this->current_position : this->start_position;
+	this->add_candidates(parent, false, active, position.x(), position.y(), child);
+
+	if (!parent_node.can_hold)
+		return;
+
+	// HOLD: SWAP WITH THE HELD PIECE, OR PUT IT AWAY AND PLAY THE NEXT ONE
+	auto held_child = parent_node;
+	held_child.can_hold = true;
+	held_child.has_held = true;
+	held_child.held = active;
+
+	auto piece = parent_node.held;
+	if (parent_node.has_held)
+		held_child.queue_index = parent_node.queue_index + 1;
+	else if (parent_node.queue_index + 1 < queue_size)
+	{
+		piece = this->queue[parent_node.queue_index + 1];
+		held_child.queue_index = parent_node.queue_index + 2;
+	}
+	else
+		return;
+
+	this->add_candidates(parent, true, piece, this->start_position.x(), this->start_position.y(), held_child);
+}
+
+void beam_search::add_candidates(const uint32_t parent, const bool hold, const tetromino piece, const int32_t start_x, const int32_t start_y, const node& child)
+{
+	const auto& shape = this->shape;
+	const auto board = this->get_board(this->current_layer, parent);
+
+	placement_search::for_each_placement(board, shape, piece, start_x, start_y,
+		[&](const tetromino& placed_piece, const int32_t rotation_y, const int32_t x, const int32_t y)
+		{
+			++this->statistics.nodes;
+
+			std::copy(board, board + shape.get_row_count(), this->scratch.begin());
+
+			auto entry = candidate{ 0.0f, 0, parent, true, placed_piece, x, y, child };
+			entry.child.lines += placement_search::place(this->scratch.data(), shape, placed_piece, x, y, entry.child.hash);
+			entry.key = this->get_key(entry.child);
+
+			// THE EVALUATION ONLY DEPENDS ON THE BOARD, LINES CLEARED ON THE WAY THERE ARE ADDED AFTER
+			auto evaluation = 0.0f;
+			const auto table = this->settings.table;
+			if (table == nullptr || !table->probe(entry.key, evaluation, this->statistics.table))
+			{
+				evaluation = placement_search::evaluate(this->scratch.data(), shape, this->settings.weights);
+				if (table != nullptr)
+					table->store(entry.key, evaluation, this->statistics.table);
+			}
+
+			entry.child.score = this->settings.weights.lines_cleared * entry.child.lines + evaluation;
+			entry.score = entry.child.score;
+
+			// THE FIRST PLACEMENT OF A LINE IS WHAT THE BOT WILL PLAY
+			if (this->depth == 0)
+				entry.child.first_move = beam_move{ hold, placement{ placed_piece.get_rotation(), rotation_y, x, y, entry.score } };
+
+			this->candidates.push_back(entry);
+		});
+}
+
+void beam_search::build_next_depth()
+{
+	// BEST CANDIDATES TO THE FRONT, TWICE AS MANY AS KEPT SO SOME CAN BE DROPPED AS TRANSPOSITIONS
+	const auto beam_width = static_cast<size_t>(this->settings.beam_width);
+	const auto considered = std::min(beam_width * 2, this->candidates.size());
+	const auto better = [](const candidate& left, const candidate& right) { return left.score > right.score; };
+	std::nth_element(this->candidates.begin(), this->candidates.begin() + (considered - 1), this->candidates.end(), better);
+	std::sort(this->candidates.begin(), this->candidates.begin() + considered, better);
+
+	const auto next_layer = 1 - this->current_layer;
+	auto& next_nodes = this->layers[next_layer];
+	next_nodes.clear();
+	this->kept_keys.clear();
+
+	for (size_t index = 0; index < considered && next_nodes.size() < beam_width; index++)
+	{
+		auto& entry = this->candidates[index];
+
+		// SAME BOARD AND QUEUE REACHED BY PLACING OR HOLDING IN ANOTHER ORDER, THE BETTER ONE IS ALREADY KEPT
+		if (std::find(this->kept_keys.begin(), this->kept_keys.end(), entry.key) != this->kept_keys.end())
+		{
+			++this->statistics.transpositions;
+			continue;
+		}
+		this->kept_keys.push_back(entry.key);
+
+		const auto source = this->get_board(this->current_layer, entry.parent);
+		const auto destination = this->get_board(next_layer, static_cast<uint32_t>(next_nodes.size()));
+		std::copy(source, source + this->shape.get_row_count(), destination);
+
+		if (entry.placed)
+		{
+			// HASH OF THE CHILD IS ALREADY KNOWN
+			auto hash = uint64_t(0);
+			placement_search::place(destination, this->shape, entry.piece, entry.x, entry.y, hash);
+		}
+
+		next_nodes.push_back(entry.child);
+	}
+
+	this->current_layer = next_layer;
+	++this->depth;
+}
+
+uint64_t beam_search::get_key(const node& state)
+{
+	const auto has_piece = state.queue_index < queue_size;
+	const auto piece = has_piece ? this->queue[state.queue_index] : tetromino();
+
+	return transposition_table::make_key(state.hash, has_piece, piece, state.has_held, state.held, state.can_hold);
+}
+
+bitboard::row_t* beam_search::get_board(const uint32_t layer, const uint32_t index)
+{
+	return this->boards.data() + (static_cast<size_t>(layer) * this->settings.beam_width + index) * this->shape.get_row_count();
+}
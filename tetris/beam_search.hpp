@@ -0,0 +1,128 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "bitboard.hpp"
+#include "board_shape.hpp"
+#include "placement_search.hpp"
+#include "tetris_engine.hpp"
+#include "tetromino.hpp"
+#include "transposition_table.hpp"
+
+struct beam_settings
+{
+	// BOARDS KEPT PER DEPTH
+	uint32_t beam_width = 32;
+
+	// A SEARCH STOPS EXPANDING AFTER THIS LONG AND PLAYS THE BEST LINE FOUND SO FAR
+	// A FRAME AT 60 HZ IS 16.6 MS
+	std::chrono::microseconds time_budget = std::chrono::microseconds(4000);
+
+	placement_weights weights;
+
+	// EVALUATIONS CACHED ACROSS SEARCHES AND THREADS, NOT OWNED, nullptr EVALUATES EVERY BOARD
+	transposition_table* table = nullptr;
+};
+
+// FIRST MOVE OF THE BEST LINE: WHETHER TO HOLD, THEN WHERE TO DROP THE PIECE IN PLAY
+struct beam_move
+{
+	bool hold;
+	placement target;
+};
+
+struct beam_statistics
+{
+	uint64_t searches = 0;
+	uint64_t nodes = 0;
+	uint64_t searches_over_budget = 0;
+	uint64_t nanoseconds = 0;
+
+	// CANDIDATES DROPPED BECAUSE A BETTER ONE REACHED THE SAME STATE BY ANOTHER ORDER OF MOVES
+	uint64_t transpositions = 0;
+	transposition_statistics table;
+};
+
+// LOOKAHEAD OVER THE CURRENT PIECE, next_piece AND THE HOLD
+// EVERY DEPTH PLACES ONE PIECE IN EVERY BOARD OF THE BEAM AND KEEPS THE BEST beam_width RESULTS
+// NODES AND THEIR BOARDS LIVE IN TWO POOLS SIZED ONCE FOR beam_width,
+// ONE FOR THE DEPTH BEING EXPANDED AND ONE FOR THE NEXT, NOTHING IS ALLOCATED PER NODE
+class beam_search
+{
+public:
+	beam_search(const beam_settings& settings = beam_settings());
+
+	// PLAY ONE TICK: SEARCH WHEN A NEW PIECE APPEARS, HOLD IF THAT WAS BETTER, THEN STEER TO THE PLACEMENT
+	step_result step(tetris_engine& engine);
+
+	// FORGET THE PLAN FOR THE CURRENT PIECE, FOR REUSING THE SEARCH IN ANOTHER GAME
+	void reset();
+
+	// BOARDS WIDER THAN board_shape::max_width ARE NOT SEARCHED, THE PIECE DROPS WHERE IT IS
+	beam_move search(tetris_engine& engine);
+
+	beam_statistics& get_statistics();
+
+private:
+	// PIECES KNOWN AHEAD OF TIME, THE ONE IN PLAY AND next_piece
+	static constexpr uint8_t queue_size = 2;
+
+	// A BOARD AFTER PLACING SOME PIECES OF THE QUEUE
+	struct node
+	{
+		float score;
+		uint32_t lines;
+		uint64_t hash;
+		uint8_t queue_index;
+		bool has_held;
+		bool can_hold;
+		tetromino held;
+		beam_move first_move;
+	};
+
+	// A NODE OF THE NEXT DEPTH BEFORE ITS BOARD IS BUILT, ONLY THE BEST beam_width ARE BUILT
+	struct candidate
+	{
+		float score;
+		uint64_t key;
+		uint32_t parent;
+		bool placed;
+		tetromino piece;
+		int32_t x;
+		int32_t y;
+		node child;
+	};
+
+	void prepare(tetris_engine& engine);
+	void expand(const uint32_t parent);
+	void add_candidates(const uint32_t parent, const bool hold, const tetromino piece, const int32_t start_x, const int32_t start_y, const node& child);
+	void build_next_depth();
+
+	// transposition_table::make_key OF A NODE
+	uint64_t get_key(const node& state);
+
+	bitboard::row_t* get_board(const uint32_t layer, const uint32_t index);
+
+	beam_settings settings;
+	beam_statistics statistics;
+
+	// PLAN FOR THE CURRENT PIECE
+	beam_move plan;
+	bool has_plan;
+
+	// POOLS FOR TWO DEPTHS, NODE i OF layer HAS ITS BOARD AT ((layer * beam_width) + i) * shape.get_row_count()
+	std::array<std::vector<node>, 2> layers;
+	std::vector<bitboard::row_t> boards;
+	std::vector<candidate> candidates;
+	std::vector<uint64_t> kept_keys;
+	std::vector<bitboard::row_t> scratch;
+	uint32_t current_layer;
+	uint32_t depth;
+
+	// BOARD AND QUEUE OF THE GAME BEING SEARCHED
+	std::array<tetromino, queue_size> queue;
+	board_shape shape;
+	screen_vector start_position;
+	screen_vector current_position;
+};
@@ -0,0 +1,1821 @@
+#include "benchmark.hpp"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+#include "allocation_counter.hpp"
+#include "array2d.hpp"
+#include "console_controller.hpp"
+#include "coordinate_data.hpp"
+#include "frame_differ.hpp"
+#include "frame_metrics.hpp"
+#include "frame_scheduler.hpp"
+#include "indexed_array2d.hpp"
+#include "input_reader.hpp"
+#include "key_repeater.hpp"
+#include "latency_histogram.hpp"
+#include "piece_bag.hpp"
+#include "placement_bot.hpp"
+#include "replay_reader.hpp"
+#include "replay_writer.hpp"
+#include "batch_simulator.hpp"
+#include "beam_search.hpp"
+#include "bitboard.hpp"
+#include "board_shape.hpp"
+#include "screen_vector.hpp"
+#include "solid_piece.hpp"
+#include "spsc_queue.hpp"
+#include "tetris.hpp"
+#include "tetris_engine.hpp"
+#include "transposition_table.hpp"
+
+namespace
+{
+	// SAME DIMENSIONS AS main.cpp
+	constexpr int32_t board_width = 14;
+	constexpr int32_t board_height = 20;
+
+	// RESULTS ARE WRITTEN HERE SO THE OPTIMIZER CAN'T THROW AWAY THE WORK
+	volatile uint64_t sink;
+
+#ifndef _WIN32
+	// console_controller DOESN'T OWN ITS OUTPUT, EVERY BENCHMARK THAT WRITES NOWHERE SHARES THIS ONE
+	int null_output()
+	{
+		static const int descriptor = open("/dev/null", O_WRONLY);
+		return descriptor;
+	}
+#endif
+
+	struct benchmark_board
+	{
+		array2d<solid_piece> solid_pieces{ board_height + 1, board_width + 1 };
+		bitboard board{ board_width, board_height };
+	};
+
+	// FILL BOTTOM HALF OF THE BOARD WITH A FIXED RANDOM PATTERN, BOTH REPRESENTATIONS MATCH
+	benchmark_board make_board()
+	{
+		benchmark_board result;
+		std::mt19937 generator(1337);
+
+		for (int32_t y = board_height / 2; y < board_height; y++)
+		{
+			for (int32_t x = 1; x < board_width - 1; x++)
+			{
+				if (generator() % 3 == 0)
+					continue;
+
+				result.solid_pieces.get_element(y, x).is_valid() = true;
+				result.board.set(x, y);
+			}
+		}
+
+		return result;
+	}
+
+	// OLD PATH: ARRAY LOOKUP PLUS FOUR BORDER COMPARISONS PER CELL
+	bool array2d_collides(array2d<solid_piece>& solid_pieces, screen_vector part, screen_vector position)
+	{
+		auto absolute_position = screen_vector(position.x() + part.x(), position.y() + part.y());
+		auto piece_collision = solid_pieces.get_element(absolute_position.y(), absolute_position.x()).is_valid();
+		auto border_collision =
+			absolute_position.y() >= board_height ||
+			absolute_position.x() < 1 ||
+			absolute_position.x() > board_width - 2 ||
+			absolute_position.y() < 1;
+
+		return piece_collision || border_collision;
+	}
+
+	bool array2d_row_full(array2d<solid_piece>& solid_pieces, int32_t y)
+	{
+		for (int32_t x = 1; x < board_width - 1; x++)
+		{
+			if (!solid_pieces.get_element(y, x).is_valid())
+				return false;
+		}
+		return true;
+	}
+
+	// PREVIOUS array2d LAYOUT, ONE HEAP ALLOCATION PER ROW
+	template <typename T>
+	struct nested_array2d
+	{
+		nested_array2d(size_t x, size_t y) : data(x, std::vector<T>(y)) {}
+
+		std::vector<std::vector<T>> data;
+	};
+
+	void benchmark_array2d()
+	{
+		// GAME BOARD, 80x25 TERMINAL, 200x60 TERMINAL AND THE 400x400 CONSOLE BUFFER
+		const std::array<std::pair<size_t, size_t>, 4> sizes = { {
+			{ board_height + 1, board_width + 1 },
+			{ 25, 80 },
+			{ 60, 200 },
+			{ 400, 400 }
+		} };
+
+		for (auto[row_count, row_size] : sizes)
+		{
+			std::printf("\n[array2d<coordinate_data>, %zu rows of %zu]\n", row_count, row_size);
+
+			auto nested = nested_array2d<coordinate_data>(row_count, row_size);
+			auto nested_other = nested_array2d<coordinate_data>(row_count, row_size);
+			auto flat = array2d<coordinate_data>(row_count, row_size);
+			auto flat_other = array2d<coordinate_data>(row_count, row_size);
+
+			// ROUGHLY 200 MILLION CELLS TOUCHED PER MEASUREMENT
+			const auto iterations = std::max<uint64_t>(1, 200'000'000 / (row_count * row_size));
+
+			const auto nested_fill = benchmark::measure(iterations, [&](uint64_t i) {
+				for (auto& row : nested.data)
+					std::fill(row.begin(), row.end(), coordinate_data(static_cast<uint16_t>(i), 0));
+			});
+			const auto flat_fill = benchmark::measure(iterations, [&](uint64_t i) {
+				flat.fill(coordinate_data(static_cast<uint16_t>(i), 0));
+			});
+
+			// COPY SO BOTH SIDES ARE EQUAL AND THE COMPARISON RUNS THROUGH THE WHOLE BUFFER
+			nested_other = nested;
+			flat_other = flat;
+
+			const auto nested_compare = benchmark::measure(iterations, [&](uint64_t) {
+				sink = sink + (nested.data == nested_other.data);
+			});
+			const auto flat_compare = benchmark::measure(iterations, [&](uint64_t) {
+				sink = sink + (flat == flat_other);
+			});
+
+			// MOVE EVERY ROW DOWN ONE, LIKE CLEARING THE BOTTOM LINE
+			const auto nested_shift = benchmark::measure(iterations, [&](uint64_t) {
+				for (size_t i = row_count - 1; i > 0; i--)
+					nested.data[i] = nested.data[i - 1];
+			});
+			const auto flat_shift = benchmark::measure(iterations, [&](uint64_t) {
+				flat.copy_rows(1, 0, row_count - 1);
+			});
+
+			benchmark::report("fill nested vectors", nested_fill);
+			benchmark::report("fill contiguous", flat_fill);
+			benchmark::report("compare nested vectors", nested_compare);
+			benchmark::report("compare contiguous", flat_compare);
+			benchmark::report("row shift nested vectors", nested_shift);
+			benchmark::report("row shift contiguous", flat_shift);
+		}
+	}
+
+	void benchmark_collision()
+	{
+		std::printf("\n[collision, %ix%i board]\n", board_width, board_height);
+
+		auto data = make_board();
+
+		// T PIECE IN ALL FOUR ROTATIONS
+		const std::array<tetromino, 4> pieces =
+		{ {
+			tetromino(tetromino_t, 0),
+			tetromino(tetromino_t, 1),
+			tetromino(tetromino_t, 2),
+			tetromino(tetromino_t, 3),
+		} };
+
+		// THE ROW MASKS AGREE WITH THE CELLS FOR EVERY PIECE, INCLUDING POSITIONS OUTSIDE THE BOARD
+		for (size_t kind = 0; kind < tetromino_count; kind++)
+		{
+			for (uint8_t rotation = 0; rotation < tetromino_table::rotation_count; rotation++)
+			{
+				const auto piece = tetromino(static_cast<tetromino_kind>(kind), rotation);
+				for (int32_t y = -8; y < board_height + 8; y++)
+				{
+					for (int32_t x = -8; x < board_width + 8; x++)
+					{
+						bool collision = false;
+						for (auto part : piece.get_elements())
+							collision |= data.board.is_occupied(x + part.x(), y + part.y());
+
+						assert(data.board.collides(piece.get_rows(), x, y) == collision);
+					}
+				}
+			}
+		}
+
+		// EVERY POSITION KEEPS THE PIECE INSIDE THE ARRAY, THE OLD PATH DOES NOT BOUNDS CHECK
+		std::mt19937 generator(7);
+		std::array<screen_vector, 256> positions;
+		for (auto& position : positions)
+		{
+			position = screen_vector(
+				static_cast<int32_t>(1 + generator() % (board_width - 2)),
+				static_cast<int32_t>(1 + generator() % (board_height - 2)));
+		}
+
+		constexpr uint64_t iterations = 20'000'000;
+
+		const auto old_time = benchmark::measure(iterations, [&](uint64_t i) {
+			auto& piece = pieces[i & 3];
+			auto position = positions[(i >> 2) & 255];
+
+			bool collision = false;
+			for (auto part : piece.get_elements())
+				collision |= array2d_collides(data.solid_pieces, part, position);
+
+			sink = sink + collision;
+		});
+
+		const auto cell_time = benchmark::measure(iterations, [&](uint64_t i) {
+			auto& piece = pieces[i & 3];
+			auto position = positions[(i >> 2) & 255];
+
+			bool collision = false;
+			for (auto part : piece.get_elements())
+				collision |= data.board.is_occupied(position.x() + part.x(), position.y() + part.y());
+
+			sink = sink + collision;
+		});
+
+		const auto new_time = benchmark::measure(iterations, [&](uint64_t i) {
+			auto& piece = pieces[i & 3];
+			auto position = positions[(i >> 2) & 255];
+
+			sink = sink + data.board.collides(piece.get_rows(), position.x(), position.y());
+		});
+
+		benchmark::report("does_element_collide array2d", old_time);
+		benchmark::report("does_element_collide bitboard, per cell", cell_time);
+		benchmark::report("does_element_collide bitboard, row masks", new_time);
+	}
+
+	void benchmark_full_lines()
+	{
+		std::printf("\n[full line scan, %ix%i board]\n", board_width, board_height);
+
+		auto data = make_board();
+
+		constexpr uint64_t iterations = 5'000'000;
+
+		const auto old_time = benchmark::measure(iterations, [&](uint64_t) {
+			uint64_t full_rows = 0;
+			for (int32_t y = 1; y < board_height; y++)
+				full_rows += array2d_row_full(data.solid_pieces, y);
+
+			sink = sink + full_rows;
+		});
+
+		const auto new_time = benchmark::measure(iterations, [&](uint64_t) {
+			uint64_t full_rows = 0;
+			for (int32_t y = 1; y < board_height; y++)
+				full_rows += data.board.is_row_full(y);
+
+			sink = sink + full_rows;
+		});
+
+		benchmark::report("handle_full_lines scan array2d", old_time);
+		benchmark::report("handle_full_lines scan bitboard", new_time);
+	}
+
+	void benchmark_line_clears()
+	{
+		for (auto height : { board_height, 200 })
+		{
+			std::printf("\n[line clears, %ix%i board]\n", board_width, height);
+
+			// EVERY ROW RANDOMLY FILLED, EACH CLEAR REFILLS THE ROWS THAT COME IN AT THE TOP SO THE BOARD STAYS DENSE
+			// THE REFILL IS THE SAME FOR BOTH PATHS
+			std::mt19937 generator(1337);
+			std::vector<bool> pattern(static_cast<size_t>(board_width) * 64);
+			for (size_t index = 0; index < pattern.size(); index++)
+				pattern[index] = generator() % 3 != 0;
+
+			const auto refill = [&](bitboard& board, auto& solid_pieces, const int32_t count, const uint64_t i)
+			{
+				for (int32_t y = 1; y <= count; y++)
+				{
+					for (int32_t x = 1; x < board_width - 1; x++)
+					{
+						if (!pattern[((i + y) % 64) * board_width + x])
+							continue;
+
+						solid_pieces.get_element(y, x).is_valid() = true;
+						board.set(x, y);
+					}
+				}
+			};
+
+			for (int32_t lines = 1; lines <= 4; lines += 3)
+			{
+				constexpr uint64_t iterations = 1'000'000;
+
+				// PREVIOUS PATH: ONE ERASE PER LINE, EVERY ROW ABOVE IT COPIED CELL BY CELL
+				auto old_board = bitboard(board_width, height);
+				auto old_pieces = array2d<solid_piece>(height + 1, board_width + 1);
+				for (int32_t y = 1; y < height; y += 64)
+					refill(old_board, old_pieces, std::min(64, height - y), y);
+
+				const auto old_time = benchmark::measure(iterations, [&](uint64_t i) {
+					for (int32_t line = 0; line < lines; line++)
+					{
+						const auto y = height - 1;
+						old_board.erase_row(y);
+						old_pieces.copy_rows(2, 1, y - 1);
+						old_pieces.fill_row(1, solid_piece());
+					}
+					refill(old_board, old_pieces, lines, i);
+				});
+
+				// ONE PASS FOR ALL LINES, SOLID PIECES ONLY MOVE ROW INDICES
+				auto new_board = bitboard(board_width, height);
+				auto new_pieces = indexed_array2d<solid_piece>(height + 1, board_width + 1);
+				for (int32_t y = 1; y < height; y += 64)
+					refill(new_board, new_pieces, std::min(64, height - y), y);
+
+				std::array<int32_t, 4> removed;
+				for (int32_t line = 0; line < lines; line++)
+					removed[line] = height - lines + line;
+
+				const auto new_time = benchmark::measure(iterations, [&](uint64_t i) {
+					new_board.erase_rows(removed.data(), lines);
+					new_pieces.erase_rows(removed.data(), lines, 1, solid_piece());
+					refill(new_board, new_pieces, lines, i);
+				});
+
+				sink = sink + old_board.get_hash() + new_board.get_hash();
+
+				std::printf("%i lines\n", lines);
+				benchmark::report("erase_row per line, rows copied", old_time);
+				benchmark::report("erase_rows, row indices moved", new_time);
+			}
+		}
+	}
+
+	// PREVIOUS rng::get_int, THREAD-LOCAL mt19937 AND A NEW DISTRIBUTION PER CALL
+	size_t legacy_get_int(size_t min, size_t max)
+	{
+		thread_local std::mt19937 generator(std::random_device{}());
+		std::uniform_int_distribution<size_t> distribution(min, max);
+		return distribution(generator);
+	}
+
+	void benchmark_piece_generation()
+	{
+		std::printf("\n[piece generation]\n");
+
+		constexpr uint64_t iterations = 20'000'000;
+
+		const auto legacy_time = benchmark::measure(iterations, [](uint64_t) {
+			sink = sink + legacy_get_int(0, tetromino_count - 1);
+		});
+
+		auto generator = rng::xoshiro256(1);
+		const auto uniform_time = benchmark::measure(iterations, [&](uint64_t) {
+			sink = sink + generator.get_int(tetromino_count);
+		});
+
+		auto bag = piece_bag(1);
+		const auto bag_time = benchmark::measure(iterations, [&](uint64_t) {
+			sink = sink + bag.next();
+		});
+
+		benchmark::report("mt19937 + uniform_int_distribution", legacy_time);
+		benchmark::report("xoshiro256::get_int", uniform_time);
+		benchmark::report("piece_bag::next", bag_time);
+
+		// SAME SEED, SAME SEQUENCE, REGARDLESS OF THE THREAD DRAWING IT
+		constexpr size_t sequence_length = 1'000;
+		std::array<tetromino_kind, sequence_length> this_thread{};
+		std::array<tetromino_kind, sequence_length> other_thread{};
+
+		auto draw = [](std::array<tetromino_kind, sequence_length>& sequence) {
+			auto bag = piece_bag(1234);
+			for (auto& kind : sequence)
+				kind = bag.next();
+		};
+
+		draw(this_thread);
+		std::thread(draw, std::ref(other_thread)).join();
+
+		std::printf("same seed on another thread: %s\n", this_thread == other_thread ? "identical" : "DIFFERENT");
+	}
+
+	void benchmark_engine()
+	{
+		std::printf("\n[headless engine, %ix%i board]\n", board_width, board_height);
+
+		// RANDOM INPUT ON ROUGHLY EVERY FOURTH TICK, NEW GAME WHENEVER THE LAST ONE ENDS
+		std::mt19937 generator(42);
+		auto engine = tetris_engine(board_width, board_height, 0);
+		engine.start();
+
+		uint64_t games = 0;
+		uint64_t pieces = 0;
+
+		constexpr uint64_t iterations = 2'000'000;
+
+		const auto time = benchmark::measure(iterations, [&](uint64_t) {
+			const auto random = generator();
+			const auto input = (random & 3) == 0 ? static_cast<uint8_t>(1 << ((random >> 2) % 6)) : static_cast<uint8_t>(input_none);
+
+			const auto result = engine.step(input);
+			pieces += result.locked;
+
+			if (result.game_over)
+			{
+				++games;
+				engine = tetris_engine(board_width, board_height, games);
+				engine.start();
+			}
+		});
+
+		sink = sink + pieces;
+
+		benchmark::report("tetris_engine::step", time);
+		std::printf("%llu games, %llu pieces locked\n", static_cast<unsigned long long>(games), static_cast<unsigned long long>(pieces));
+	}
+
+	// GHOST POSITION THE WAY IT WAS FOUND BEFORE THE ENGINE KEPT COLUMN TOPS, ONE ROW PER COLLISION TEST
+	screen_vector stepwise_drop_position(tetris_engine& engine)
+	{
+		auto& piece = engine.get_current_piece().get_piece();
+		auto position = engine.get_current_piece().get_position();
+
+		auto collision = false;
+		do
+		{
+			++position.y();
+
+			for (auto part : piece.get_elements())
+				collision |= engine.get_board().is_occupied(position.x() + part.x(), position.y() + part.y());
+		} while (!collision);
+
+		--position.y();
+		return position;
+	}
+
+	void benchmark_drop_position()
+	{
+		// THE BOT KEEPS ITS STACK LOW, SO ON A TALL BOARD MOST PIECES FALL A LONG WAY
+		for (auto height : { board_height, 200 })
+		{
+			std::printf("\n[ghost and hard drop, %ix%i board]\n", board_width, height);
+
+			// A PIECE AT EVERY HEIGHT OF ITS FALL, AS THE GHOST IS DRAWN EVERY FRAME
+			std::vector<tetris_engine> positions;
+			auto bot = placement_bot();
+			auto engine = tetris_engine(board_width, height, 7);
+			engine.start();
+			while (positions.size() < 4096)
+			{
+				if (bot.step(engine).game_over)
+				{
+					engine = tetris_engine(board_width, height, positions.size());
+					engine.start();
+					bot.reset();
+				}
+
+				positions.push_back(engine);
+			}
+
+			uint64_t rows_fallen = 0;
+			for (auto& position : positions)
+			{
+				auto expected = stepwise_drop_position(position);
+				auto actual = position.get_drop_position();
+				assert(expected.x() == actual.x() && expected.y() == actual.y());
+
+				rows_fallen += actual.y() - position.get_current_piece().get_position().y();
+			}
+
+			constexpr uint64_t iterations = 2'000'000;
+			const auto stepwise_time = benchmark::measure(iterations, [&](uint64_t i) {
+				sink = sink + stepwise_drop_position(positions[i % positions.size()]).y();
+			});
+			const auto skyline_time = benchmark::measure(iterations, [&](uint64_t i) {
+				sink = sink + positions[i % positions.size()].get_drop_position().y();
+			});
+
+			benchmark::report("row by row", stepwise_time);
+			benchmark::report("tetris_engine::get_drop_position", skyline_time);
+			std::printf("%.1f rows fallen on average, %.1fx faster\n", static_cast<double>(rows_fallen) / positions.size(), stepwise_time / skyline_time);
+		}
+	}
+
+	void benchmark_scaling()
+	{
+		std::printf("\n[scaling, board width x height including the border]\n");
+		std::printf("%-14s %14s %14s %14s %14s %8s\n", "", "collision", "ghost", "line clear", "step", "words");
+
+		for (auto width : { 14, 64, 250, 1000 })
+		{
+			for (auto height : { 20, 2'000, 30'000 })
+			{
+				std::mt19937 generator(width ^ height);
+
+				// DROP PIECES AT RANDOM COLUMNS UNTIL THE STACK IS A FEW ROWS OF HOLES AND OVERHANGS
+				auto engine = tetris_engine(width, height, 0);
+				engine.start();
+				for (auto piece = 0; piece < width * 2 && !engine.is_game_over(); piece++)
+				{
+					engine.get_current_piece().get_position().x() = 2 + generator() % (width - 5);
+					engine.step(input_hard_drop);
+				}
+				auto& board = engine.get_board();
+
+				// A PIECE ANYWHERE ON THE BOARD, ROWS THAT STRADDLE TWO WORDS INCLUDED
+				std::array<screen_vector, 256> positions;
+				for (auto& position : positions)
+					position = screen_vector(2 + generator() % (width - 5), 1 + generator() % (height - 4));
+
+				const auto collision_time = benchmark::measure(4'000'000, [&](uint64_t i) {
+					auto position = positions[i % positions.size()];
+					const auto piece = tetromino(static_cast<tetromino_kind>(i % tetromino_count));
+					sink = sink + board.collides(piece.get_rows(), position.x(), position.y());
+				});
+
+				// GHOST OF A PIECE AT THE TOP, THE WHOLE HEIGHT OF THE BOARD ABOVE THE STACK
+				for (auto& position : positions)
+					position = screen_vector(2 + generator() % (width - 5), 1);
+
+				for (size_t index = 0; index < 64 && !engine.is_game_over(); index++)
+				{
+					engine.get_current_piece().get_position() = positions[index];
+					auto expected = stepwise_drop_position(engine);
+					auto actual = engine.get_drop_position();
+					assert(expected.x() == actual.x() && expected.y() == actual.y());
+				}
+
+				const auto ghost_time = benchmark::measure(1'000'000, [&](uint64_t i) {
+					engine.get_current_piece().get_position() = positions[i % positions.size()];
+					sink = sink + engine.get_drop_position().y();
+				});
+
+				// A STACK OF EIGHT ROWS WITH ONE HOLE EACH, EVERY ITERATION FILLS THE HOLE OF THE BOTTOM ROW,
+				// CLEARS IT AND BUILDS A NEW ROW ON TOP SO THE STACK STAYS THE SAME. ONLY THE CLEAR IS TIMED
+				constexpr int32_t stack_rows = 8;
+				constexpr uint64_t clears = 100'000;
+				auto clear_board = bitboard(width, height);
+				std::vector<int32_t> holes;
+				const auto build_row = [&](const int32_t y) {
+					holes.insert(holes.begin(), 1 + generator() % (width - 2));
+					for (int32_t x = 1; x < width - 1; x++)
+					{
+						if (x != holes.front())
+							clear_board.set(x, y);
+					}
+				};
+				for (auto y = height - 1; y >= height - stack_rows; y--)
+					build_row(y);
+
+				std::chrono::nanoseconds clear_elapsed{};
+				for (uint64_t iteration = 0; iteration < clears; iteration++)
+				{
+					const auto bottom = height - 1;
+					const auto start_time = std::chrono::steady_clock::now();
+					clear_board.set(holes.back(), bottom);
+					clear_board.erase_rows(&bottom, 1);
+					clear_elapsed += std::chrono::steady_clock::now() - start_time;
+
+					holes.pop_back();
+					build_row(height - stack_rows);
+				}
+
+				// INCREMENTAL HASH AND COLUMN TOPS MATCH A BOARD BUILT FROM SCRATCH
+				auto rebuilt = bitboard(width, height);
+				for (auto y = height - stack_rows; y < height; y++)
+					for (int32_t x = 1; x < width - 1; x++)
+						if (clear_board.is_occupied(x, y))
+							rebuilt.set(x, y);
+				assert(rebuilt.get_hash() == clear_board.get_hash());
+				for (int32_t x = 1; x < width - 1; x++)
+					assert(rebuilt.get_column_top(x) == clear_board.get_column_top(x));
+
+				// RANDOM INPUT ON ROUGHLY EVERY FOURTH TICK, SAME AS benchmark_engine
+				const auto step_time = benchmark::measure(1'000'000, [&](uint64_t) {
+					const auto random = generator();
+					const auto input = (random & 3) == 0 ? static_cast<uint8_t>(1 << ((random >> 2) % 6)) : static_cast<uint8_t>(input_none);
+
+					if (engine.step(input).game_over)
+					{
+						engine = tetris_engine(width, height, random);
+						engine.start();
+					}
+				});
+
+				char size[16];
+				std::snprintf(size, sizeof(size), "%ix%i", width, height);
+				std::printf("%-14s %8.2f ns/op %8.2f ns/op %8.2f ns/op %8.2f ns/op %8i\n", size, collision_time, ghost_time,
+					static_cast<double>(clear_elapsed.count()) / clears, step_time, board.get_words_per_row());
+			}
+		}
+
+		// THE ENGINE TAKES ANY WIDTH, THE SEARCHES ONLY board_shape::max_width. WIDER, THE BOTS DROP THE PIECE WHERE IT IS
+		// AND A BATCH IS REJECTED
+		{
+			auto engine = tetris_engine(board_shape::max_width + 1, board_height, 0);
+			engine.start();
+			const auto dropped = placement_search::drop_in_place(engine);
+
+			auto bot = placement_bot();
+			const auto best = bot.find_best_placement(engine);
+			assert(best.rotation == dropped.rotation && best.x == dropped.x && best.y == dropped.y);
+
+			auto search = beam_search();
+			const auto move = search.search(engine);
+			assert(!move.hold && move.target.rotation == dropped.rotation && move.target.x == dropped.x && move.target.y == dropped.y);
+
+			auto settings = batch_settings();
+			settings.width = 1'000;
+			const auto report = batch_simulator(settings).run();
+			assert(report.board_too_wide && report.games == 0);
+
+			std::printf("%i columns and wider are not searched\n", board_shape::max_width + 1);
+		}
+	}
+
+	void benchmark_replay()
+	{
+		std::printf("\n[replay, %ix%i board]\n", board_width, board_height);
+
+		// RECORD ONE GAME WITH A KEYFRAME EVERY SECOND, THE GAMES ARE SHORT
+		const auto path = "tetris_benchmark.replay";
+		std::mt19937 generator(42);
+
+		auto engine = tetris_engine(board_width, board_height, 99);
+		engine.start();
+
+		{
+			auto writer = replay_writer(path, tetris_engine::ticks_per_second);
+			writer.begin(engine);
+
+			for (auto game_over = false; !game_over; )
+			{
+				const auto random = generator();
+				const auto input = (random & 3) == 0 ? static_cast<uint8_t>(1 << ((random >> 2) % 6)) : static_cast<uint8_t>(input_none);
+
+				writer.record(engine, input);
+				game_over = engine.step(input).game_over;
+			}
+		}
+
+		std::vector<uint8_t> expected_state;
+		engine.save_state(expected_state);
+
+		auto reader = replay_reader(path);
+		const auto ticks = engine.get_tick();
+
+		const auto file_size = static_cast<long>(std::ifstream(path, std::ios::binary | std::ios::ate).tellg());
+
+		// FULL SPEED PLAYBACK FROM TICK 0
+		std::vector<uint8_t> replayed_state;
+		constexpr uint64_t playbacks = 2'000;
+		const auto playback_time = benchmark::measure(playbacks, [&](uint64_t) {
+			auto replayed = reader.create_engine();
+			reader.seek(replayed, 0);
+
+			uint8_t input = input_none;
+			while (reader.next(input))
+				replayed.step(input);
+
+			replayed_state.clear();
+			replayed.save_state(replayed_state);
+		});
+
+		// SEEK TO THE LAST TICK, FROM A KEYFRAME AND FROM THE START
+		const auto keyframe_seek_time = benchmark::measure(playbacks, [&](uint64_t) {
+			auto replayed = reader.create_engine();
+			sink = sink + reader.seek(replayed, ticks);
+		});
+
+		auto keyframes = std::move(reader.get_keyframes());
+		const auto full_seek_time = benchmark::measure(playbacks, [&](uint64_t) {
+			auto replayed = reader.create_engine();
+			sink = sink + reader.seek(replayed, ticks);
+		});
+		reader.get_keyframes() = std::move(keyframes);
+
+		std::remove(path);
+
+		std::printf("%llu ticks, %ld bytes (%.3f bytes/tick), %zu keyframes\n",
+			static_cast<unsigned long long>(ticks), file_size, static_cast<double>(file_size) / ticks, reader.get_keyframes().size());
+		benchmark::report("replay playback, per tick", playback_time / ticks);
+		benchmark::report("seek to last tick from keyframe", keyframe_seek_time);
+		benchmark::report("seek to last tick from tick 0", full_seek_time);
+		std::printf("replayed state %s recorded state\n", replayed_state == expected_state ? "matches" : "DOES NOT MATCH");
+	}
+
+	void benchmark_bot()
+	{
+		std::printf("\n[placement bot, %ix%i board]\n", board_width, board_height);
+
+		// FULL GAMES ON ONE CORE, CAPPED SO A GOOD RUN CAN'T STALL THE BENCHMARK
+		constexpr uint64_t games = 20;
+		constexpr uint64_t tick_limit = 1'000'000;
+
+		auto bot = placement_bot();
+		uint64_t ticks = 0;
+		uint64_t pieces = 0;
+		uint64_t lines = 0;
+		uint64_t capped = 0;
+
+		const auto game_time = benchmark::measure(games, [&](uint64_t game) {
+			auto engine = tetris_engine(board_width, board_height, game);
+			engine.start();
+			bot.reset();
+
+			while (true)
+			{
+				const auto result = bot.step(engine);
+				pieces += result.locked;
+				lines += result.lines_cleared;
+
+				if (result.game_over)
+					break;
+
+				if (engine.get_tick() == tick_limit)
+				{
+					++capped;
+					break;
+				}
+			}
+
+			ticks += engine.get_tick();
+		});
+
+		const auto evaluated = bot.get_placements_evaluated();
+
+		// PLACEMENT SEARCH ALONE, OVER BOARDS TAKEN FROM A BOT GAME
+		std::vector<tetris_engine> positions;
+		auto engine = tetris_engine(board_width, board_height, games);
+		engine.start();
+		bot.reset();
+		while (positions.size() < 256 && !engine.is_game_over())
+		{
+			if (bot.step(engine).locked)
+				positions.push_back(engine);
+		}
+
+		constexpr uint64_t searches = 100'000;
+		const auto evaluated_before_search = bot.get_placements_evaluated();
+		const auto search_time = benchmark::measure(searches, [&](uint64_t i) {
+			sink = sink + bot.find_best_placement(positions[i % positions.size()]).x;
+		});
+		const auto placements_per_search = static_cast<double>(bot.get_placements_evaluated() - evaluated_before_search) / searches;
+
+		benchmark::report("full bot game", game_time);
+		benchmark::report("tick played by bot", game_time * games / ticks);
+		benchmark::report("placement_bot::find_best_placement", search_time);
+		benchmark::report("placement evaluated", search_time / placements_per_search);
+		std::printf("%.1f pieces, %.1f lines per game, %llu of %llu games hit %llu ticks, %.1f placements per piece\n",
+			static_cast<double>(pieces) / games, static_cast<double>(lines) / games,
+			static_cast<unsigned long long>(capped), static_cast<unsigned long long>(games), static_cast<unsigned long long>(tick_limit),
+			static_cast<double>(evaluated) / pieces);
+	}
+
+	void benchmark_beam_search()
+	{
+		std::printf("\n[beam search, %ix%i board]\n", board_width, board_height);
+
+		// THE SEARCH RARELY LOSES, SO GAMES ARE CUT AT ABOUT 5 MINUTES OF PLAY
+		constexpr uint64_t games = 2;
+		constexpr uint64_t tick_limit = 20'000;
+
+		for (auto beam_width : { 8u, 32u })
+		{
+			auto settings = beam_settings();
+			settings.beam_width = beam_width;
+
+			auto search = beam_search(settings);
+			uint64_t pieces = 0;
+			uint64_t lines = 0;
+			uint64_t capped = 0;
+
+			for (uint64_t game = 0; game < games; game++)
+			{
+				auto engine = tetris_engine(board_width, board_height, game);
+				engine.start();
+				search.reset();
+
+				while (true)
+				{
+					const auto result = search.step(engine);
+					pieces += result.locked;
+					lines += result.lines_cleared;
+
+					if (result.game_over)
+						break;
+
+					if (engine.get_tick() == tick_limit)
+					{
+						++capped;
+						break;
+					}
+				}
+			}
+
+			auto& statistics = search.get_statistics();
+			const auto nodes_per_search = static_cast<double>(statistics.nodes) / statistics.searches;
+
+			std::printf("beam width %u\n", beam_width);
+			benchmark::report("beam_search::search", static_cast<double>(statistics.nanoseconds) / statistics.searches);
+			benchmark::report("node", static_cast<double>(statistics.nanoseconds) / statistics.nodes);
+			std::printf("%.0f nodes per search, %llu of %llu searches over the %lld us budget\n",
+				nodes_per_search, static_cast<unsigned long long>(statistics.searches_over_budget), static_cast<unsigned long long>(statistics.searches),
+				static_cast<long long>(settings.time_budget.count()));
+			std::printf("%.1f pieces, %.1f lines per game, %llu of %llu games hit %llu ticks\n",
+				static_cast<double>(pieces) / games, static_cast<double>(lines) / games,
+				static_cast<unsigned long long>(capped), static_cast<unsigned long long>(games), static_cast<unsigned long long>(tick_limit));
+		}
+	}
+
+	void benchmark_transposition_table()
+	{
+		std::printf("\n[zobrist hash and transposition table, %ix%i board]\n", board_width, board_height);
+
+		// THE INCREMENTAL HASHES MUST MATCH A FULL REHASH, FOR THE ENGINE AFTER EVERY LOCK
+		// AND FOR placement_search::place OVER EVERY PLACEMENT OF EVERY PIECE
+		{
+			const auto shape = board_shape(board_width, board_height);
+			std::vector<bitboard::row_t> rows(shape.get_row_count());
+			std::vector<bitboard::row_t> scratch(shape.get_row_count());
+
+			auto bot = placement_bot();
+			uint64_t boards_checked = 0;
+			uint64_t mismatches = 0;
+
+			for (uint64_t game = 0; game < 4; game++)
+			{
+				auto engine = tetris_engine(board_width, board_height, game);
+				engine.start();
+				bot.reset();
+
+				auto result = step_result();
+				auto new_piece = true;
+				while (!result.game_over && engine.get_tick() < 200'000)
+				{
+					if (new_piece)
+					{
+						const auto board_hash = engine.get_board().get_hash();
+						placement_search::copy_rows(engine, rows.data());
+						mismatches += placement_search::hash_rows(rows.data(), shape) != board_hash;
+						++boards_checked;
+
+						auto& current = engine.get_current_piece();
+						placement_search::for_each_placement(rows.data(), shape, current.get_piece(), current.get_position().x(), current.get_position().y(),
+							[&](const tetromino& piece, const int32_t, const int32_t x, const int32_t y)
+							{
+								auto hash = board_hash;
+								scratch = rows;
+								placement_search::place(scratch.data(), shape, piece, x, y, hash);
+								mismatches += placement_search::hash_rows(scratch.data(), shape) != hash;
+								++boards_checked;
+							});
+					}
+
+					result = bot.step(engine);
+					new_piece = result.locked;
+				}
+			}
+
+			std::printf("%llu boards hashed incrementally, %llu differ from a full rehash\n",
+				static_cast<unsigned long long>(boards_checked), static_cast<unsigned long long>(mismatches));
+			assert(mismatches == 0);
+		}
+
+		// EVERY CELL OF A WIDE AND TALL BOARD HAS ITS OWN KEY, ROWS 64 APART AND BITS OF LATER WORDS INCLUDED
+		{
+			constexpr int32_t wide_width = 250;
+			constexpr int32_t tall_height = 1'000;
+			std::vector<uint64_t> keys;
+			for (int32_t y = 0; y < tall_height; y++)
+				for (int32_t x = 1; x < wide_width - 1; x++)
+					keys.push_back(zobrist::cell_key(x + bitboard::margin, y));
+
+			std::sort(keys.begin(), keys.end());
+			const auto distinct = std::unique(keys.begin(), keys.end()) - keys.begin();
+			std::printf("%lld distinct keys for the %llu cells of a %ix%i board\n",
+				static_cast<long long>(distinct), static_cast<unsigned long long>(keys.size()), wide_width, tall_height);
+			assert(distinct == static_cast<int64_t>(keys.size()));
+		}
+
+		// A LINE CLEAR THAT MOVES ROWS INTO ANOTHER BAND OF 64 LINES REKEYS THEM, BOTH HASHES STAY EXACT
+		// A STACK FROM LINE 40 TO THE FLOOR WITH A WELL IN COLUMN 1, ONLY THE BOTTOM ROWS ARE SOLID NEXT TO IT
+		{
+			constexpr int32_t tall_height = 100;
+			auto board = bitboard(board_width, tall_height);
+			for (int32_t y = 40; y < tall_height; y++)
+				for (int32_t x = 2; x < board_width - 1; x++)
+					if (y > 90 || (x + y) % 7 != 0)
+						board.set(x, y);
+
+			const auto shape = board_shape(board_width, tall_height);
+			std::vector<bitboard::row_t> rows(shape.get_row_count());
+			for (int32_t y = 1; y < tall_height; y++)
+				rows[y - 1] = board.get_row(y)[0];
+
+			// AN I DOWN THE WELL CLEARS THE BOTTOM FOUR ROWS AND MOVES LINES 60 TO 63 PAST LINE 64
+			auto scratch = rows;
+			auto cleared_hash = uint64_t(0);
+			uint64_t placements = 0;
+			uint64_t mismatches = 0;
+			placement_search::for_each_placement(rows.data(), shape, tetromino(tetromino_i), shape.get_width() / 2, 1,
+				[&](const tetromino& piece, const int32_t, const int32_t x, const int32_t y)
+				{
+					scratch = rows;
+					auto hash = board.get_hash();
+					if (placement_search::place(scratch.data(), shape, piece, x, y, hash) == 4)
+						cleared_hash = hash;
+
+					mismatches += placement_search::hash_rows(scratch.data(), shape) != hash;
+					++placements;
+				});
+
+			const int32_t cleared[] = { 96, 97, 98, 99 };
+			for (auto y : cleared)
+				board.set(1, y);
+			board.erase_rows(cleared, 4);
+
+			auto rebuilt = bitboard(board_width, tall_height);
+			for (int32_t y = 1; y < tall_height; y++)
+				for (int32_t x = 1; x < board_width - 1; x++)
+					if (board.is_occupied(x, y))
+						rebuilt.set(x, y);
+
+			std::printf("%llu placements on a %ix%i board, %llu differ from a full rehash\n",
+				static_cast<unsigned long long>(placements), board_width, tall_height, static_cast<unsigned long long>(mismatches));
+			assert(mismatches == 0);
+			assert(rebuilt.get_hash() == board.get_hash());
+			assert(cleared_hash == board.get_hash());
+		}
+
+		// SEARCH THREADS PLAYING THEIR OWN GAMES, WITH AND WITHOUT ONE SHARED TABLE
+		const auto threads = std::max(2u, std::thread::hardware_concurrency());
+		constexpr uint64_t tick_limit = 5'000;
+
+		auto table = transposition_table();
+		for (auto shared : { false, true })
+		{
+			table.clear();
+
+			std::vector<beam_statistics> statistics(threads);
+			std::vector<std::thread> workers;
+			for (uint32_t thread = 0; thread < threads; thread++)
+			{
+				workers.emplace_back([&, thread]()
+					{
+						auto settings = beam_settings();
+						settings.table = shared ? &table : nullptr;
+
+						auto search = beam_search(settings);
+						auto engine = tetris_engine(board_width, board_height, thread);
+						engine.start();
+
+						while (!search.step(engine).game_over && engine.get_tick() < tick_limit)
+							;
+
+						statistics[thread] = search.get_statistics();
+					});
+			}
+			for (auto& worker : workers)
+				worker.join();
+
+			auto total = beam_statistics();
+			for (auto& entry : statistics)
+			{
+				total.searches += entry.searches;
+				total.nodes += entry.nodes;
+				total.nanoseconds += entry.nanoseconds;
+				total.transpositions += entry.transpositions;
+				total.table.probes += entry.table.probes;
+				total.table.hits += entry.table.hits;
+				total.table.sampled_probes += entry.table.sampled_probes;
+				total.table.sampled_nanoseconds += entry.table.sampled_nanoseconds;
+			}
+
+			std::printf("%u threads, %s\n", threads, shared ? "shared table" : "no table");
+			benchmark::report("beam_search::search", static_cast<double>(total.nanoseconds) / total.searches);
+			benchmark::report("node", static_cast<double>(total.nanoseconds) / total.nodes);
+			std::printf("%.1f transpositions dropped per search\n", static_cast<double>(total.transpositions) / total.searches);
+
+			if (shared)
+			{
+				std::printf("%llu probes, %.1f%% hits, %.1f ns per probe (1 in %llu timed)\n",
+					static_cast<unsigned long long>(total.table.probes), 100.0 * total.table.hits / total.table.probes,
+					static_cast<double>(total.table.sampled_nanoseconds) / total.table.sampled_probes,
+					static_cast<unsigned long long>(transposition_table::sample_interval));
+			}
+		}
+	}
+
+	void benchmark_batch()
+	{
+		const auto hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+		std::printf("\n[batch simulator, %ix%i board, %u hardware threads]\n", board_width, board_height, hardware_threads);
+
+		// 1, 2, 4 ... THREADS, AND THE HARDWARE COUNT IF IT ISN'T A POWER OF TWO
+		std::vector<uint32_t> thread_counts;
+		for (uint32_t threads = 1; threads < hardware_threads; threads *= 2)
+			thread_counts.push_back(threads);
+		thread_counts.push_back(hardware_threads);
+
+		double single_thread_rate = 0.0;
+		for (auto threads : thread_counts)
+		{
+			auto settings = batch_settings();
+			settings.width = board_width;
+			settings.height = board_height;
+			settings.games = 32 * threads;
+			settings.threads = threads;
+
+			const auto start_time = std::chrono::steady_clock::now();
+			const auto report = batch_simulator(settings).run();
+			const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+			const auto games_per_second = report.games / seconds;
+			if (threads == 1)
+				single_thread_rate = games_per_second;
+
+			std::printf("%3u threads: %8.1f games/s %6.2fx, %llu games, %.1f lines/game, %llu steals\n",
+				threads, games_per_second, games_per_second / single_thread_rate,
+				static_cast<unsigned long long>(report.games), static_cast<double>(report.total_lines) / report.games,
+				static_cast<unsigned long long>(report.steals));
+		}
+	}
+
+	void benchmark_frame_metrics()
+	{
+		std::printf("\n[frame metrics]\n");
+
+		// UNIFORM 1 NS TO 1 MS, PERCENTILES ARE BUCKET UPPER BOUNDS SO THEY MAY BE UP TO 12.5% HIGH
+		auto histogram = latency_histogram();
+		std::mt19937 generator(5);
+		constexpr uint64_t iterations = 5'000'000;
+
+		const auto add_time = benchmark::measure(iterations, [&](uint64_t) {
+			histogram.add(generator() % 1'000'000 + 1);
+		});
+
+		for (auto percentile : { 50.0, 95.0, 99.0 })
+		{
+			const auto expected = percentile / 100.0 * 1'000'000;
+			const auto actual = static_cast<double>(histogram.get_percentile(percentile));
+			assert(actual >= expected * 0.99 && actual <= expected * 1.125 + 1);
+			sink = sink + static_cast<uint64_t>(actual);
+		}
+		assert(histogram.get_count() == iterations && histogram.get_max() <= 1'000'000);
+
+		benchmark::report("latency_histogram::add", add_time);
+
+		// WHAT EVERY PHASE OF A FRAME PAYS, A FRAME HAS TEN
+		if (frame_metrics::enabled)
+		{
+			auto metrics = frame_metrics();
+			auto phase_start = metrics.now();
+			const auto lap_time = benchmark::measure(iterations, [&](uint64_t i) {
+				phase_start = metrics.lap(static_cast<frame_phase>(i % phase_input_latency), phase_start);
+			});
+
+			benchmark::report("frame_metrics::lap", lap_time);
+			std::printf("%.3f%% of a 16.6 ms frame for %u phases\n", lap_time * phase_input_latency / 16'666'666.0 * 100.0, static_cast<uint32_t>(phase_input_latency));
+		}
+		else
+			std::printf("frame_metrics::lap compiled out, build with TETRIS_FRAME_METRICS\n");
+	}
+
+	void benchmark_allocations()
+	{
+		std::printf("\n[heap allocations, %ix%i board]\n", board_width, board_height);
+
+		if (!allocation_counter::is_enabled())
+		{
+			std::printf("skipped, build with TETRIS_COUNT_ALLOCATIONS\n");
+			return;
+		}
+
+		// ONE FULL GAME WITH EVERY ACTION, CONSTRUCTION IS COUNTED SEPARATELY
+		std::mt19937 generator(7);
+		const auto before_construction = allocation_counter::get_count();
+
+		auto engine = tetris_engine(board_width, board_height, 7);
+		engine.start();
+
+		const auto before_game = allocation_counter::get_count();
+
+		uint64_t ticks = 0;
+		uint64_t pieces = 0;
+		for (auto game_over = false; !game_over; ++ticks)
+		{
+			const auto random = generator();
+			const auto input = (random & 3) == 0 ? static_cast<uint8_t>(1 << ((random >> 2) % 6)) : static_cast<uint8_t>(input_none);
+
+			const auto result = engine.step(input);
+			pieces += result.locked;
+			game_over = result.game_over;
+		}
+
+		const auto after_game = allocation_counter::get_count();
+
+		std::printf("construction: %llu allocations\n", static_cast<unsigned long long>(before_game - before_construction));
+		std::printf("full game: %llu allocations over %llu ticks, %llu pieces\n",
+			static_cast<unsigned long long>(after_game - before_game),
+			static_cast<unsigned long long>(ticks),
+			static_cast<unsigned long long>(pieces));
+
+		// A TICK MUST NEVER ALLOCATE, THE WHOLE GAME RUNS ON MEMORY RESERVED BY THE CONSTRUCTOR
+		assert(after_game == before_game);
+
+		// BEAM SEARCH SIZES ITS POOLS ON THE FIRST SEARCH, LATER SEARCHES MUST NOT ALLOCATE
+		auto search = beam_search();
+		auto searched = tetris_engine(board_width, board_height, 7);
+		searched.start();
+		search.search(searched);
+
+		const auto before_search = allocation_counter::get_count();
+		uint64_t searches = 0;
+		while (searches < 200 && !searched.is_game_over())
+			searches += search.step(searched).locked;
+		const auto after_search = allocation_counter::get_count();
+
+		std::printf("beam search: %llu allocations over %llu searches after the first\n",
+			static_cast<unsigned long long>(after_search - before_search), static_cast<unsigned long long>(searches));
+		assert(after_search == before_search);
+	}
+
+	void benchmark_console_output()
+	{
+		std::printf("\n[console output, %ix%i board]\n", board_width, board_height);
+
+		// WINDOWS DRAWS TO THE VISIBLE CONSOLE, POSIX WRITES THE ESCAPE SEQUENCES TO /dev/null
+#ifdef _WIN32
+		console_controller console(GetStdHandle(STD_OUTPUT_HANDLE), 400, 400);
+#else
+		console_controller console(null_output(), 400, 400);
+#endif
+		console.toggle_buffer_render(true);
+
+		for (int16_t y = 0; y <= board_height; y++)
+			console.fill_horizontal(0, y, '#', board_width, console_color::dark_cyan);
+
+		std::mt19937 generator(42);
+		uint64_t games = 0;
+		auto engine = tetris_engine(board_width, board_height, games);
+		engine.start();
+
+		constexpr uint32_t frames = 2'000;
+		uint64_t bytes_written = 0;
+		uint64_t syscalls = 0;
+		uint64_t cells_scanned = 0;
+		uint64_t cells_emitted = 0;
+
+		for (uint32_t frame = 0; frame < frames; frame++)
+		{
+			const auto random = generator();
+			const auto input = (random & 3) == 0 ? static_cast<uint8_t>(1 << ((random >> 2) % 6)) : static_cast<uint8_t>(input_none);
+
+			if (engine.step(input).game_over)
+			{
+				engine = tetris_engine(board_width, board_height, ++games);
+				engine.start();
+			}
+
+			// SAME SCENE AS THE GAME: EMPTY FRAME, SOLID PARTS AND THE FALLING PIECE
+			console.clear(1, 1, board_width - 2, board_height - 1);
+
+			for (int16_t y = 1; y < board_height; y++)
+			{
+				for (int16_t x = 1; x < board_width - 1; x++)
+				{
+					auto& solid_piece = engine.get_solid_pieces().get_element(y, x);
+					if (solid_piece.is_valid())
+						console.draw(x, y, '#', solid_piece.get_color());
+				}
+			}
+
+			auto& current_piece = engine.get_current_piece();
+			for (auto part : current_piece.get_piece().get_elements())
+				console.draw(current_piece.get_position().x() + part.x(), current_piece.get_position().y() + part.y(), '#', current_piece.get_piece().get_color());
+
+			console.update_scene();
+
+			bytes_written += console.get_frame_statistics().bytes_written;
+			syscalls += console.get_frame_statistics().syscalls;
+			cells_scanned += console.get_frame_statistics().cells_scanned;
+			cells_emitted += console.get_frame_statistics().cells_emitted;
+		}
+
+		const auto viewport = console.get_viewport_size();
+		std::printf("%-48s %10.2f cells/frame (frame is %ix%i cells)\n", "update_scene scanned", static_cast<double>(cells_scanned) / frames, viewport.first, viewport.second);
+		std::printf("%-48s %10.2f cells/frame\n", "update_scene emitted", static_cast<double>(cells_emitted) / frames);
+
+		std::printf("%-48s %10.2f bytes/frame\n", "update_scene", static_cast<double>(bytes_written) / frames);
+		std::printf("%-48s %10.2f syscalls/frame\n", "update_scene", static_cast<double>(syscalls) / frames);
+
+		// clear() ONLY EMPTIES THE COLUMNS AND ROWS THAT WERE DRAWN TO
+		console.clear();
+		console.update_scene();
+		std::printf("%-48s %10u cells\n", "clear", console.get_frame_statistics().cells_written);
+		assert(console.get_frame_statistics().cells_written == static_cast<uint32_t>(board_width * (board_height + 1)));
+
+		// DRAWING PAST ANY EDGE IS CUT OFF, NOT WRITTEN OUT OF BOUNDS
+		console.draw(-3, 0, "abcdef");
+		console.draw(viewport.first - 2, 1, "abcdef");
+		console.draw(0, viewport.second, "abcdef");
+		console.draw(0, -1, '#');
+		console.fill_horizontal(viewport.first - 1, 2, '#', 10);
+		console.clear(-5, -5, 10, 10);
+		console.update_scene();
+
+		assert(console.read(0, 0) == 0 && console.read(0, 1) == 0);
+		assert(console.read(viewport.first - 2, 1) == 'a' && console.read(viewport.first - 1, 1) == 'b');
+		assert(console.read(viewport.first - 1, 2) == '#');
+		assert(console.read(viewport.first, 2) == 0 && console.read(0, viewport.second) == 0);
+		assert(console.get_frame_statistics().cells_written == 3 + 2 + 1 + 5 * 5);
+	}
+
+	void benchmark_layers()
+	{
+		std::printf("\n[layered compositor, %ix%i board with hud]\n", board_width, board_height);
+
+		// THE GAME SCREEN REDRAWING EVERY REGION EVERY FRAME, AS THE FIXED SCHEDULER DOES
+		// BEFORE: ONE LAYER, THE BORDER DRAWN ONCE BUT THE LABELS WITH EVERY HUD VALUE
+		// AFTER: BORDER AND LABELS ONCE ON THE BACKGROUND, THE HUD LAYER ONLY WHEN A VALUE CHANGES
+		for (const auto layered : { false, true })
+		{
+#ifdef _WIN32
+			console_controller console(GetStdHandle(STD_OUTPUT_HANDLE), 400, 400);
+#else
+			console_controller console(null_output(), 400, 400);
+#endif
+			console.toggle_buffer_render(true);
+			console.set_layer_count(layered ? 3 : 1);
+
+			const auto draw_piece = [&console](const int16_t x, const int16_t y, const tetromino& piece, const uint8_t color_code)
+			{
+				for (auto part : piece.get_elements())
+					console.draw(x + part.x(), y + part.y(), '#', color_code);
+			};
+
+			console.select_layer(0);
+			for (int16_t y = 0; y <= board_height; y++)
+				console.fill_horizontal(0, y, '#', board_width, console_color::dark_cyan);
+
+			console.clear(1, 1, board_width - 2, board_height - 1);
+			if (layered)
+			{
+				console.draw(board_width + 3, 1, "Score count:", console_color::white);
+				console.draw(board_width + 3, 3, "Next up:", console_color::white);
+				console.draw(board_width + 3, 10, "Saved piece:", console_color::white);
+			}
+
+			console.update_scene();
+
+			std::mt19937 generator(42);
+			uint64_t games = 0;
+			auto engine = tetris_engine(board_width, board_height, games);
+			engine.start();
+
+			constexpr uint32_t frames = 20'000;
+			uint64_t cells_written = 0;
+			uint64_t cells_composited = 0;
+			uint64_t cells_emitted = 0;
+			uint64_t bytes_written = 0;
+			uint32_t drawn_score = UINT32_MAX;
+			auto drawn_next = tetromino();
+
+			const auto start_time = std::chrono::steady_clock::now();
+
+			for (uint32_t frame = 0; frame < frames; frame++)
+			{
+				const auto random = generator();
+				const auto input = (random & 3) == 0 ? static_cast<uint8_t>(1 << ((random >> 2) % 6)) : static_cast<uint8_t>(input_none);
+
+				if (engine.step(input).game_over)
+				{
+					engine = tetris_engine(board_width, board_height, ++games);
+					engine.start();
+				}
+
+				// BOARD
+				console.select_layer(1);
+				console.clear(1, 1, board_width - 2, board_height - 1);
+
+				for (int16_t y = 1; y < board_height; y++)
+				{
+					for (int16_t x = 1; x < board_width - 1; x++)
+					{
+						auto& solid_piece = engine.get_solid_pieces().get_element(y, x);
+						if (solid_piece.is_valid())
+							console.draw(x, y, '#', solid_piece.get_color());
+					}
+				}
+
+				auto& current_piece = engine.get_current_piece();
+				draw_piece(current_piece.get_position().x(), current_piece.get_position().y(), current_piece.get_piece(), current_piece.get_piece().get_color());
+
+				// HUD
+				console.select_layer(2);
+				const auto score = static_cast<uint32_t>(engine.get_score());
+				if (!layered)
+				{
+					char score_buffer[25];
+					std::snprintf(score_buffer, sizeof(score_buffer), "Score count: %u", score);
+					console.draw(board_width + 3, 1, score_buffer, console_color::white);
+				}
+				else if (score != drawn_score)
+				{
+					char score_buffer[10];
+					const auto result = std::to_chars(score_buffer, score_buffer + sizeof(score_buffer), score);
+					console.clear(board_width + 16, 1, sizeof(score_buffer), 1);
+					console.draw(board_width + 16, 1, std::string_view(score_buffer, result.ptr - score_buffer), console_color::white);
+				}
+
+				auto& next_piece = engine.get_next_piece().get_piece();
+				if (!layered)
+				{
+					console.clear(board_width + 2, 3, 10, 10);
+					console.draw(board_width + 3, 3, "Next up:", console_color::white);
+					draw_piece(board_width + 6, 5, next_piece, next_piece.get_color());
+
+					// NOTHING IS HELD, THE LABEL IS STILL REDRAWN
+					console.clear(board_width + 2, 10, 10, 10);
+					console.draw(board_width + 3, 10, "Saved piece:", console_color::white);
+				}
+				else if (next_piece != drawn_next)
+				{
+					console.clear(board_width + 2, 4, 10, 6);
+					draw_piece(board_width + 6, 5, next_piece, next_piece.get_color());
+				}
+
+				drawn_score = score;
+				drawn_next = next_piece;
+
+				console.update_scene();
+
+				cells_written += console.get_frame_statistics().cells_written;
+				cells_composited += console.get_frame_statistics().cells_composited;
+				cells_emitted += console.get_frame_statistics().cells_emitted;
+				bytes_written += console.get_frame_statistics().bytes_written;
+			}
+
+			const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+
+			const auto name = layered ? "after, 3 layers" : "before, 1 layer";
+			std::printf("%-16s %10.2f written %10.2f composited %10.2f emitted cells/frame %10.2f bytes/frame %10.2f ns/frame\n", name,
+				static_cast<double>(cells_written) / frames, static_cast<double>(cells_composited) / frames,
+				static_cast<double>(cells_emitted) / frames, static_cast<double>(bytes_written) / frames,
+				static_cast<double>(elapsed) / frames);
+		}
+	}
+
+	void benchmark_board_render()
+	{
+		std::printf("\n[board render, %ix%i board, half full]\n", board_width, board_height);
+
+		// THE LOWER HALF OF THE BOARD MOSTLY FULL, LIKE A GAME AFTER A WHILE
+		std::mt19937 generator(23);
+		auto solid_pieces = array2d<solid_piece>(board_height + 1, board_width + 1);
+		for (int16_t y = board_height / 2; y < board_height; y++)
+		{
+			for (int16_t x = 1; x < board_width - 1; x++)
+			{
+				auto& piece = solid_pieces.get_element(y, x);
+				piece.is_valid() = generator() % 10 < 7;
+				piece.get_color() = static_cast<uint16_t>(1 + generator() % 15);
+			}
+		}
+
+		const auto width = board_width - 2;
+		const auto height = board_height - 1;
+
+		std::array<coordinate_data, 17> cell_palette{};
+		for (uint16_t color_code = 0; color_code < 16; color_code++)
+			cell_palette[color_code + 1] = coordinate_data('#', color_code);
+		std::vector<coordinate_data> board_cells(static_cast<size_t>(width) * height);
+
+#ifdef _WIN32
+		console_controller per_cell(GetStdHandle(STD_OUTPUT_HANDLE), 400, 400);
+		console_controller blitted(GetStdHandle(STD_OUTPUT_HANDLE), 400, 400);
+#else
+		console_controller per_cell(null_output(), 400, 400);
+		console_controller blitted(null_output(), 400, 400);
+#endif
+		per_cell.toggle_buffer_render(true);
+		blitted.toggle_buffer_render(true);
+
+		constexpr uint32_t iterations = 200'000;
+		const auto cells = static_cast<double>(width) * height;
+
+		// BEFORE: CLEAR THE INSIDE, THEN ONE draw PER SOLID PART THROUGH get_element
+		auto start_time = std::chrono::steady_clock::now();
+		for (uint32_t iteration = 0; iteration < iterations; iteration++)
+		{
+			per_cell.clear(1, 1, width, height);
+			for (int16_t y = 1; y <= height; y++)
+			{
+				for (int16_t x = 1; x <= width; x++)
+				{
+					auto& piece = solid_pieces.get_element(y, x);
+					if (piece.is_valid())
+						per_cell.draw(x, y, '#', piece.get_color());
+				}
+			}
+		}
+		const auto per_cell_elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+
+		// AFTER: ROWS OF THE BOARD THROUGH THE PALETTE INTO ONE BUFFER, ONE blit
+		start_time = std::chrono::steady_clock::now();
+		for (uint32_t iteration = 0; iteration < iterations; iteration++)
+		{
+			auto cell = board_cells.begin();
+			for (int32_t y = 1; y <= height; y++)
+			{
+				const auto row = solid_pieces.get_row(y).begin() + 1;
+				for (int32_t x = 0; x < width; x++, cell++)
+					*cell = cell_palette[row[x].is_valid() * (1 + (row[x].get_color() & 0xF))];
+			}
+
+			blitted.blit(1, 1, board_cells.data(), width, height, width);
+		}
+		const auto blit_elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+
+		for (const auto& [name, elapsed] : { std::make_pair("draw per cell", per_cell_elapsed), std::make_pair("palette and blit", blit_elapsed) })
+		{
+			const auto nanoseconds = static_cast<double>(elapsed) / iterations;
+			std::printf("%-48s %10.2f ns/board %10.2f Mcells/s\n", name, nanoseconds, cells * 1e3 / nanoseconds);
+		}
+
+		// BOTH SHOW THE SAME BOARD
+		per_cell.update_scene();
+		blitted.update_scene();
+		for (int16_t y = 1; y <= height; y++)
+			for (int16_t x = 1; x <= width; x++)
+				assert(per_cell.read(x, y) == blitted.read(x, y));
+	}
+
+	void benchmark_frame_diff()
+	{
+		std::printf("\n[frame diff, whole rows, frame_differ picks %s]\n", frame_differ::get_isa_name(frame_differ::get_best_isa()));
+
+		for (const auto& [width, height] : { std::make_pair(80, 25), std::make_pair(200, 60), std::make_pair(400, 400) })
+		{
+			// A GAME FRAME CHANGES A FEW SHORT RUNS, A SCROLLING OR FLASHING SCREEN MOST OF IT
+			for (const auto changed_percent : { 1, 50 })
+			{
+				std::mt19937 generator(width * height + changed_percent);
+				std::vector<uint32_t> previous_frame(static_cast<size_t>(width) * height);
+				for (auto& cell : previous_frame)
+					cell = generator() & 0x000F00FF;
+
+				auto new_frame = previous_frame;
+				for (size_t index = 0; index < new_frame.size();)
+				{
+					const auto run = 1 + generator() % 4;
+					if (generator() % 100 < static_cast<uint32_t>(changed_percent))
+					{
+						for (size_t cell = index; cell < std::min(index + run, new_frame.size()); cell++)
+							new_frame[cell] ^= 0x00010000;
+					}
+					index += run;
+				}
+
+				std::vector<cell_span> expected;
+				std::vector<cell_span> spans;
+				const auto iterations = std::max<uint64_t>(20, 20'000'000 / new_frame.size());
+
+				for (auto isa = diff_scalar; isa < diff_isa_count; isa = static_cast<diff_isa>(isa + 1))
+				{
+					if (!frame_differ::is_supported(isa))
+						continue;
+
+					auto differ = frame_differ(isa);
+					const auto time = benchmark::measure(iterations, [&](uint64_t) {
+						spans.clear();
+						for (int16_t row = 0; row < height; row++)
+							differ.diff_row(new_frame.data() + row * width, previous_frame.data() + row * width, row, 0, static_cast<int16_t>(width), spans);
+					});
+
+					// EVERY INSTRUCTION SET FINDS THE SAME RUNS AS THE SCALAR LOOP
+					if (isa == diff_scalar)
+						expected = spans;
+					assert(spans.size() == expected.size());
+					for (size_t index = 0; index < spans.size(); index++)
+						assert(spans[index].row == expected[index].row && spans[index].first == expected[index].first && spans[index].last == expected[index].last);
+
+					char name[64];
+					std::snprintf(name, sizeof(name), "diff %ix%i, %i%% changed, %s", width, height, changed_percent, frame_differ::get_isa_name(isa));
+					std::printf("%-48s %10.2f ns/frame %8.2f cells/ns %8zu spans\n", name, time, new_frame.size() / time, spans.size());
+				}
+			}
+		}
+	}
+
+	void benchmark_scheduler()
+	{
+		// NOBODY PRESSES A KEY, SO THIS IS THE IDLE COST: GRAVITY EVERY 15 TICKS AND NOTHING ELSE
+		constexpr uint64_t ticks = 3 * tetris_engine::ticks_per_second;
+		std::printf("\n[frame scheduler, idle game for %llu ticks]\n", static_cast<unsigned long long>(ticks));
+
+		for (const auto mode : { scheduler_fixed, scheduler_event })
+		{
+#ifdef _WIN32
+			console_controller console(GetStdHandle(STD_OUTPUT_HANDLE), 400, 400);
+#else
+			console_controller console(null_output(), 400, 400);
+#endif
+			console.toggle_buffer_render(true);
+
+			auto game = tetris(console, board_width, board_height, '#');
+			game.get_scheduler().get_mode() = mode;
+			game.set_tick_limit(ticks);
+
+			const auto start_time = std::chrono::steady_clock::now();
+			const auto start_cpu = frame_scheduler::get_process_cpu_nanoseconds();
+
+			game.play();
+
+			const auto cpu = frame_scheduler::get_process_cpu_nanoseconds() - start_cpu;
+			const auto wall = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+			const auto seconds = static_cast<double>(wall) / 1e9;
+			auto& statistics = game.get_scheduler().get_statistics();
+
+			const auto name = mode == scheduler_fixed ? "fixed 60 Hz" : "event driven";
+			std::printf("%-16s %8.3f%% cpu %10.2f wakeups/s %10.2f frames/s\n", name,
+				100.0 * static_cast<double>(cpu) / static_cast<double>(wall),
+				static_cast<double>(statistics.wakeups) / seconds, static_cast<double>(statistics.frames_rendered) / seconds);
+		}
+	}
+
+	// SEND A KEY TO THE INPUT READER THE WAY THE CONSOLE WOULD
+#ifdef _WIN32
+	void send_key(const HANDLE input, const int32_t key)
+	{
+		INPUT_RECORD records[2] = {};
+		for (auto index = 0; index < 2; index++)
+		{
+			records[index].EventType = KEY_EVENT;
+			records[index].Event.KeyEvent.bKeyDown = index == 0;
+			records[index].Event.KeyEvent.wRepeatCount = 1;
+			records[index].Event.KeyEvent.wVirtualKeyCode = static_cast<WORD>(key);
+		}
+
+		DWORD written;
+		WriteConsoleInputW(input, records, 2, &written);
+	}
+#else
+	void send_key(const int input, const int32_t key)
+	{
+		const char* sequence = key == key_left ? "\x1b[D" : key == key_right ? "\x1b[C" : "\x1b[A";
+		if (write(input, sequence, 3) != 3)
+			std::fprintf(stderr, "send_key: write failed\n");
+	}
+#endif
+
+	void benchmark_input()
+	{
+		std::printf("\n[input]\n");
+
+		// ONE THREAD PUSHES, ANOTHER POPS, THE SUM PROVES NOTHING WAS LOST OR REORDERED
+		{
+			constexpr uint64_t iterations = 2'000'000;
+			auto queue = std::make_unique<spsc_queue<uint64_t, 256>>();
+
+			const auto start_time = std::chrono::steady_clock::now();
+			auto producer = std::thread([&]() {
+				for (uint64_t value = 0; value < iterations; value++)
+				{
+					while (!queue->try_push(value))
+						std::this_thread::yield();
+				}
+			});
+
+			uint64_t expected = 0;
+			uint64_t value;
+			while (expected < iterations)
+			{
+				if (!queue->try_pop(value))
+				{
+					std::this_thread::yield();
+					continue;
+				}
+
+				assert(value == expected);
+				++expected;
+			}
+			producer.join();
+
+			const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+			benchmark::report("spsc_queue push + pop across threads", static_cast<double>(elapsed) / iterations);
+			sink = sink + expected;
+		}
+
+		// DAS AND ARR COME FROM THE TIMESTAMPS: HOLD LEFT FOR 500 MS AND STEP 60 TICKS A SECOND
+		// ONE MOVE ON THE PRESS, THE FIRST REPEAT AT 167 MS, THEN ONE EVERY 33 MS UP TO 500 MS
+		{
+			auto queue = std::make_unique<key_event_queue>();
+			auto repeater = key_repeater();
+			const auto origin = key_repeater::clock::now();
+			const auto tick_length = std::chrono::nanoseconds(1'000'000'000 / tetris_engine::ticks_per_second);
+
+			queue->try_push({ key_left, true, origin + std::chrono::milliseconds(1) });
+			queue->try_push({ key_left, false, origin + std::chrono::milliseconds(501) });
+
+			// TWO TAPS OF RIGHT INSIDE ONE TICK STILL MOVE TWICE
+			queue->try_push({ key_right, true, origin + std::chrono::milliseconds(600) });
+			queue->try_push({ key_right, false, origin + std::chrono::milliseconds(601) });
+			queue->try_push({ key_right, true, origin + std::chrono::milliseconds(602) });
+			queue->try_push({ key_right, false, origin + std::chrono::milliseconds(603) });
+
+			uint32_t left_moves = 0;
+			uint32_t right_moves = 0;
+			for (uint32_t tick = 1; tick <= 60; tick++)
+			{
+				const auto input = repeater.get_input(*queue, origin + tick_length * tick);
+				left_moves += (input & input_left) != 0;
+				right_moves += (input & input_right) != 0;
+			}
+
+			const auto expected_repeats = (500 - 167) / 33 + 1;
+			std::printf("left held 500 ms: %u moves (1 + %i repeats), right tapped twice in one tick: %u moves\n", left_moves, expected_repeats, right_moves);
+			assert(left_moves == 1 + expected_repeats && right_moves == 2);
+			assert(repeater.get_next_repeat() == key_repeater::clock::time_point::max());
+		}
+
+		// A KEY EVERY 20-80 MS INTO A RUNNING GAME, FROM THE READER TIMESTAMP TO THE END OF THE TICK
+		// THE FIXED SCHEDULER ONLY LOOKS AT THE QUEUE ONCE A FRAME, LIKE SAMPLING KEYS ONCE A FRAME DID
+		for (const auto mode : { scheduler_fixed, scheduler_event })
+		{
+#ifdef _WIN32
+			console_controller console(GetStdHandle(STD_OUTPUT_HANDLE), 400, 400);
+			const auto input_handle = console.get_input_handle();
+			const auto output_handle = input_handle;
+			if (input_handle == INVALID_HANDLE_VALUE)
+			{
+				std::printf("input latency needs a console\n");
+				return;
+			}
+#else
+			console_controller console(null_output(), 400, 400);
+			int input_pipe[2];
+			if (pipe(input_pipe) != 0)
+				return;
+			const auto input_handle = input_pipe[0];
+			const auto output_handle = input_pipe[1];
+#endif
+			console.toggle_buffer_render(true);
+
+			auto game = tetris(console, board_width, board_height, '#');
+			game.get_scheduler().get_mode() = mode;
+			game.get_input().get_input_handle() = input_handle;
+			game.set_tick_limit(2 * tetris_engine::ticks_per_second);
+
+			auto feeder = std::thread([&]() {
+				std::mt19937 generator(static_cast<uint32_t>(mode));
+				const auto end_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(1900);
+				while (std::chrono::steady_clock::now() < end_time)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(20 + generator() % 60));
+					send_key(output_handle, generator() % 2 ? key_left : key_right);
+				}
+			});
+
+			game.play();
+			feeder.join();
+
+#ifndef _WIN32
+			close(input_pipe[0]);
+			close(input_pipe[1]);
+#endif
+
+			auto& latency = game.get_input_latency();
+			const auto name = mode == scheduler_fixed ? "fixed 60 Hz" : "event driven";
+			std::printf("%-16s input to state over %3llu keys: mean %8.1f us p50 %8.1f us p99 %8.1f us max %8.1f us\n", name,
+				static_cast<unsigned long long>(latency.get_count()), latency.get_count() != 0 ? latency.get_total() / 1e3 / latency.get_count() : 0.0,
+				latency.get_percentile(50.0) / 1e3, latency.get_percentile(99.0) / 1e3, latency.get_max() / 1e3);
+		}
+	}
+
+	// THE TERMINAL STOPS READING FOR 2 OF THE 3 SECONDS OF A GAME, LIKE A STALLED REMOTE SESSION
+	// RENDERING ON ITS OWN THREAD, ONLY THE RENDER THREAD BLOCKS AND THE GAME STILL TICKS 60 TIMES A SECOND
+	void benchmark_slow_terminal()
+	{
+		constexpr uint64_t ticks = 3 * tetris_engine::ticks_per_second;
+		std::printf("\n[slow terminal, %llu ticks, output stalls from 0.2 s to 2.2 s]\n", static_cast<unsigned long long>(ticks));
+
+#ifdef _WIN32
+		std::printf("needs a socket as the console, POSIX only\n");
+#else
+		// A UNIX SOCKET WITH THE SMALLEST BUFFER FILLS AFTER A FEW FRAMES, THEN write BLOCKS
+		int sink[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, sink) != 0)
+			return;
+
+		const int buffer_size = 1;
+		setsockopt(sink[0], SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+		setsockopt(sink[1], SOL_SOCKET, SO_SNDBUF, &buffer_size, sizeof(buffer_size));
+
+		const auto start_time = std::chrono::steady_clock::now();
+		const auto stall_start = start_time + std::chrono::milliseconds(200);
+		const auto stall_end = start_time + std::chrono::milliseconds(2200);
+
+		uint64_t bytes_read = 0;
+		auto terminal = std::thread([&]() {
+			char buffer[4096];
+			while (true)
+			{
+				const auto now = std::chrono::steady_clock::now();
+				if (now >= stall_start && now < stall_end)
+					std::this_thread::sleep_until(stall_end);
+
+				const auto count = read(sink[0], buffer, sizeof(buffer));
+				if (count <= 0)
+					return;
+
+				bytes_read += count;
+			}
+		});
+
+		{
+			console_controller console(sink[1], 400, 400);
+			console.toggle_buffer_render(true);
+
+			// KEEP THE PIECE MOVING SO EVERY FRAME HAS SOMETHING TO WRITE
+			int input_pipe[2];
+			if (pipe(input_pipe) != 0)
+				return;
+
+			auto game = tetris(console, board_width, board_height, '#');
+			game.get_scheduler().get_mode() = scheduler_fixed;
+			game.get_input().get_input_handle() = input_pipe[0];
+			game.set_tick_limit(ticks);
+
+			auto feeder = std::thread([&]() {
+				for (uint32_t key = 0; std::chrono::steady_clock::now() < start_time + std::chrono::milliseconds(2800); key++)
+				{
+					send_key(input_pipe[1], key % 4 == 0 ? key_up : key % 4 < 3 ? key_left : key_right);
+					std::this_thread::sleep_for(std::chrono::milliseconds(20));
+				}
+			});
+
+			game.play();
+			feeder.join();
+			close(input_pipe[0]);
+			close(input_pipe[1]);
+
+			const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+			auto& statistics = game.get_scheduler().get_statistics();
+
+			std::printf("%-48s %10.2f s for %llu ticks, %.2f ticks/s\n", "game", seconds, static_cast<unsigned long long>(ticks), ticks / seconds);
+			std::printf("%-48s %10llu rendered %10llu dropped\n", "frames", static_cast<unsigned long long>(statistics.frames_rendered), static_cast<unsigned long long>(statistics.frames_dropped));
+
+			// DROPPED FRAMES ARE THE ONLY EFFECT OF THE STALL, NOT LOST TICKS
+			assert(seconds < 3.5);
+			assert(statistics.frames_dropped > 0);
+		}
+
+		shutdown(sink[1], SHUT_WR);
+		terminal.join();
+		close(sink[0]);
+		close(sink[1]);
+
+		std::printf("%-48s %10llu bytes\n", "terminal read", static_cast<unsigned long long>(bytes_read));
+#endif
+	}
+}
+
+void benchmark::run_all()
+{
+	benchmark_array2d();
+	benchmark_collision();
+	benchmark_full_lines();
+	benchmark_line_clears();
+	benchmark_piece_generation();
+	benchmark_engine();
+	benchmark_drop_position();
+	benchmark_scaling();
+	benchmark_replay();
+	benchmark_bot();
+	benchmark_beam_search();
+	benchmark_transposition_table();
+	benchmark_batch();
+	benchmark_frame_metrics();
+	benchmark_allocations();
+	benchmark_console_output();
+	benchmark_layers();
+	benchmark_board_render();
+	benchmark_frame_diff();
+	benchmark_scheduler();
+	benchmark_input();
+	benchmark_slow_terminal();
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+// MICRO BENCHMARKS OF THE GAME LOGIC, RUN WITH "tetris --benchmark"
+namespace benchmark
+{
+	// RUN EVERY BENCHMARK AND PRINT RESULTS TO STDOUT
+	void run_all();
+
+	// TIME A CALLABLE OVER A FIXED AMOUNT OF ITERATIONS, RETURNS NANOSECONDS PER ITERATION
+	template <typename T>
+	inline double measure(const uint64_t iterations, T&& function)
+	{
+		const auto start_time = std::chrono::steady_clock::now();
+
+		for (uint64_t i = 0; i < iterations; i++)
+			function(i);
+
+		const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time);
+		return static_cast<double>(elapsed.count()) / static_cast<double>(iterations);
+	}
+
+	// PRINT A SINGLE RESULT LINE
+	inline void report(const char* name, const double nanoseconds_per_iteration)
+	{
+		std::printf("%-48s %10.2f ns/op %14.0f op/s\n", name, nanoseconds_per_iteration, 1e9 / nanoseconds_per_iteration);
+	}
+}
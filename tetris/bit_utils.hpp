@@ -0,0 +1,57 @@
+#pragma once
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <cstdint>
+
+// BIT SCANS AND POPULATION COUNT OF A 64-BIT WORD, ONE INSTRUCTION WHERE THE COMPILER HAS ONE
+namespace bit_utils
+{
+	// NUMBER OF SET BITS
+	inline int32_t count_bits(const uint64_t value)
+	{
+#if defined(_MSC_VER) && defined(_M_X64)
+		return static_cast<int32_t>(__popcnt64(value));
+#elif defined(_MSC_VER)
+		return static_cast<int32_t>(__popcnt(static_cast<uint32_t>(value)) + __popcnt(static_cast<uint32_t>(value >> 32)));
+#else
+		return __builtin_popcountll(value);
+#endif
+	}
+
+	// INDEX OF THE LOWEST SET BIT, value MUST NOT BE 0
+	inline int32_t lowest_bit(const uint64_t value)
+	{
+#if defined(_MSC_VER) && defined(_M_X64)
+		unsigned long index;
+		_BitScanForward64(&index, value);
+		return static_cast<int32_t>(index);
+#elif defined(_MSC_VER)
+		unsigned long index;
+		if (_BitScanForward(&index, static_cast<uint32_t>(value)))
+			return static_cast<int32_t>(index);
+		_BitScanForward(&index, static_cast<uint32_t>(value >> 32));
+		return static_cast<int32_t>(index) + 32;
+#else
+		return __builtin_ctzll(value);
+#endif
+	}
+
+	// INDEX OF THE HIGHEST SET BIT, value MUST NOT BE 0
+	inline int32_t highest_bit(const uint64_t value)
+	{
+#if defined(_MSC_VER) && defined(_M_X64)
+		unsigned long index;
+		_BitScanReverse64(&index, value);
+		return static_cast<int32_t>(index);
+#elif defined(_MSC_VER)
+		unsigned long index;
+		if (_BitScanReverse(&index, static_cast<uint32_t>(value >> 32)))
+			return static_cast<int32_t>(index) + 32;
+		_BitScanReverse(&index, static_cast<uint32_t>(value));
+		return static_cast<int32_t>(index);
+#else
+		return 63 - __builtin_clzll(value);
+#endif
+	}
+}
@@ -0,0 +1,129 @@
+#include "bitboard.hpp"
+#include <algorithm>
+
+bitboard::bitboard(const int32_t width, const int32_t height) :
+	words_per_row(make_words_per_row(width)), empty_row(words_per_row), rows(static_cast<size_t>(height + margin * 2) * words_per_row, full_row),
+	row_keys(height + margin * 2, 0), hash(0), column_tops(width, height)
+{
+	for (int32_t word = 0; word < this->words_per_row; word++)
+		this->empty_row[word] = make_empty_row(width, word);
+
+	// ROW 0 IS THE TOP BORDER, ROW HEIGHT AND BELOW IS THE BOTTOM BORDER
+	for (int32_t y = 1; y < height; y++)
+		std::copy(this->empty_row.begin(), this->empty_row.end(), this->get_row(y));
+
+	// BORDER COLUMNS ARE SOLID ALL THE WAY UP, INSIDE COLUMNS START AT THE FLOOR
+	if (width > 0)
+	{
+		this->column_tops.front() = 1;
+		this->column_tops.back() = 1;
+	}
+}
+
+void bitboard::erase_row(const int32_t y)
+{
+	this->erase_rows(&y, 1);
+}
+
+void bitboard::erase_rows(const int32_t* removed, const int32_t count)
+{
+	if (count == 0)
+		return;
+
+	// EVERY ROW ABOVE THE LOWEST REMOVED ONE MOVES DOWN BY THE NUMBER OF REMOVED ROWS BELOW IT
+	// ROWS ABOVE THE STACK ARE EMPTY AND STAY EMPTY, SO THE WORK ENDS AT THE STACK TOP, NOT AT ROW 1
+	// REMOVED ROWS LEAVE THE HASH, MOVED ROWS ARE ONE ROTATION OF THEIR KEY EACH
+	// UNLESS THEY MOVE INTO ANOTHER BAND OF 64 LINES, SEE zobrist.hpp
+	// ONE-WORD ROWS, THE USUAL BOARD SIZES, ARE MOVED AS ONE WORD INSTEAD OF A COPY CALL PER ROW
+	const auto stack_top = this->get_stack_top();
+	auto next = count - 1;
+	auto destination = removed[count - 1];
+	for (auto source = removed[count - 1]; source >= stack_top; source--)
+	{
+		const auto key = this->row_keys[source + margin];
+		if (next >= 0 && removed[next] == source)
+		{
+			this->hash ^= zobrist::rotate_left(key, source);
+			--next;
+			continue;
+		}
+
+		auto moved_key = key;
+		if (key != 0)
+		{
+			if (!zobrist::same_band(source, destination))
+				moved_key = this->make_row_key(source, destination);
+
+			this->hash ^= zobrist::rotate_left(key, source) ^ zobrist::rotate_left(moved_key, destination);
+		}
+
+		if (this->words_per_row == 1)
+			*this->get_row(destination) = *this->get_row(source);
+		else
+			std::copy_n(this->get_row(source), this->words_per_row, this->get_row(destination));
+
+		this->row_keys[destination + margin] = moved_key;
+		--destination;
+	}
+
+	for (auto y = stack_top; y <= destination; y++)
+	{
+		if (this->words_per_row == 1)
+			*this->get_row(y) = this->empty_row.front();
+		else
+			std::copy(this->empty_row.begin(), this->empty_row.end(), this->get_row(y));
+
+		this->row_keys[y + margin] = 0;
+	}
+
+	// A COLUMN TOP MOVES WITH ITS ROW, A TOP ON A REMOVED ROW IS SEARCHED FOR AGAIN BELOW
+	// WHERE THE EMPTY CELLS ABOVE IT ENDED UP. THE FLOOR IS ALWAYS SOLID, THE SEARCH ENDS THERE AT THE LATEST
+	for (int32_t x = 1; x < static_cast<int32_t>(this->column_tops.size()) - 1; x++)
+	{
+		auto& top = this->column_tops[x];
+		if (top > removed[count - 1])
+			continue;
+
+		auto removed_below = 0;
+		auto on_removed_row = false;
+		for (auto index = 0; index < count; index++)
+		{
+			removed_below += removed[index] > top;
+			on_removed_row |= removed[index] == top;
+		}
+
+		top += removed_below;
+		if (on_removed_row)
+		{
+			const auto word = (x + margin) / word_bits;
+			const auto bit = row_t(1) << ((x + margin) % word_bits);
+			while (!(this->get_row(top)[word] & bit))
+				++top;
+		}
+	}
+}
+
+int32_t bitboard::get_stack_top()
+{
+	auto stack_top = static_cast<int32_t>(this->rows.size());
+	for (int32_t x = 1; x < static_cast<int32_t>(this->column_tops.size()) - 1; x++)
+		stack_top = std::min(stack_top, this->column_tops[x]);
+
+	return stack_top;
+}
+
+uint64_t bitboard::make_row_key(const int32_t source, const int32_t y)
+{
+	const auto row = this->get_row(source);
+
+	uint64_t key = 0;
+	for (int32_t word = 0; word < this->words_per_row; word++)
+		key ^= row_key(row[word] & ~this->empty_row[word], y, word);
+
+	return key;
+}
+
+auto bitboard::get_hash() -> uint64_t
+{
+	return this->hash;
+}
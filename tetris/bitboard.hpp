@@ -0,0 +1,196 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "bit_utils.hpp"
+#include "tetromino.hpp"
+#include "zobrist.hpp"
+
+// OCCUPANCY OF THE PLAYFIELD, ONE OR MORE MACHINE WORDS PER ROW
+// BIT (X + MARGIN) OF ROW (Y + MARGIN) IS SET WHEN CELL (X, Y) IS SOLID,
+// BIT b OF A ROW IS BIT b % 64 OF ITS WORD b / 64. BOARDS UP TO 56 COLUMNS TAKE ONE WORD
+// THE BORDER IS BAKED INTO EVERY ROW, SO A SINGLE AND TELLS
+// IF A CELL COLLIDES WITH EITHER A SOLID PIECE OR THE BORDER
+struct bitboard
+{
+	using row_t = uint64_t;
+	static constexpr int32_t word_bits = sizeof(row_t) * 8;
+
+	// ROTATED PIECES CAN REACH UP TO THREE CELLS OUTSIDE THE BORDER,
+	// PAD EACH SIDE SO SHIFTS AND ROW INDICES NEVER GO NEGATIVE
+	static constexpr int32_t margin = 4;
+
+	// EVERY BIT SET, A ROW IS FULL WHEN IT MATCHES THIS
+	static constexpr row_t full_row = ~row_t(0);
+
+	bitboard() = default;
+
+	// WIDTH AND HEIGHT INCLUDE THE BORDER, SAME AS tetris::border_width/border_height
+	bitboard(const int32_t width, const int32_t height);
+
+	// WORDS A ROW OF A BOARD width WIDE TAKES, MARGINS INCLUDED
+	static constexpr int32_t make_words_per_row(const int32_t width)
+	{
+		return (width + margin * 2 + word_bits - 1) / word_bits;
+	}
+
+	// WORD word OF A ROW INSIDE THE BORDER WITHOUT ANY SOLID PIECES: EVERY BIT SET BUT COLUMNS 1 TO WIDTH - 2
+	static constexpr row_t make_empty_row(const int32_t width, const int32_t word = 0)
+	{
+		auto row = full_row;
+		for (int32_t x = 1; x < width - 1; x++)
+		{
+			const auto bit = x + margin - word * word_bits;
+			if (bit >= 0 && bit < word_bits)
+				row &= ~(row_t(1) << bit);
+		}
+
+		return row;
+	}
+
+	// TRUE IF CELL IS SOLID, PART OF THE BORDER OR OUTSIDE THE BOARD
+	inline bool is_occupied(const int32_t x, const int32_t y)
+	{
+		const auto row_index = static_cast<uint32_t>(y + margin);
+		const auto bit_index = static_cast<uint32_t>(x + margin);
+
+		if (row_index >= this->row_keys.size() || bit_index >= static_cast<uint32_t>(this->words_per_row * word_bits))
+			return true;
+
+		return (this->rows[row_index * this->words_per_row + bit_index / word_bits] >> (bit_index % word_bits)) & 1;
+	}
+
+	// SAME AS is_occupied FOR EVERY CELL OF A PIECE AT (x, y), ONE SHIFT AND AND PER ROW OF THE PIECE
+	// A PIECE COVERS EVERY ROW AND COLUMN OF ITS MASKS, SO IF THE MASKS ARE INSIDE THE ARRAY ALL CELLS ARE
+	inline bool collides(const tetromino_table::row_masks& piece, const int32_t x, const int32_t y)
+	{
+		const auto bit_index = x + piece.left + margin;
+		const auto row_index = y + piece.top + margin;
+
+		if (bit_index < 0 || bit_index + piece.width > this->words_per_row * word_bits ||
+			row_index < 0 || row_index + piece.row_count > static_cast<int32_t>(this->row_keys.size()))
+			return true;
+
+		const auto shift = bit_index % word_bits;
+		auto row = this->rows.data() + static_cast<size_t>(row_index) * this->words_per_row + bit_index / word_bits;
+
+		// ONLY ON BOARDS OF MORE THAN ONE WORD PER ROW CAN THE PIECE REACH INTO THE NEXT WORD
+		if (shift + piece.width > word_bits)
+		{
+			for (int32_t index = 0; index < piece.row_count; index++, row += this->words_per_row)
+			{
+				const auto mask = static_cast<row_t>(piece.masks[index]);
+				if ((row[0] & (mask << shift)) || (row[1] & (mask >> (word_bits - shift))))
+					return true;
+			}
+
+			return false;
+		}
+
+		row_t overlap = 0;
+		for (int32_t index = 0; index < piece.row_count; index++, row += this->words_per_row)
+			overlap |= row[0] & (static_cast<row_t>(piece.masks[index]) << shift);
+
+		return overlap != 0;
+	}
+
+	// ALSO UPDATES THE HASH, SETTING A SOLID CELL AGAIN CHANGES NOTHING
+	inline void set(const int32_t x, const int32_t y)
+	{
+		const auto bit_index = x + margin;
+		auto& word = this->get_row(y)[bit_index / word_bits];
+		const auto bit = row_t(1) << (bit_index % word_bits);
+		if (word & bit)
+			return;
+
+		word |= bit;
+		this->row_keys[y + margin] ^= zobrist::column_key(bit_index, y);
+		this->hash ^= zobrist::cell_key(bit_index, y);
+
+		if (y < this->column_tops[x])
+			this->column_tops[x] = y;
+	}
+
+	inline bool is_row_full(const int32_t y)
+	{
+		const auto row = this->get_row(y);
+
+		// BOARDS UP TO 56 COLUMNS, ONE COMPARE
+		if (this->words_per_row == 1)
+			return row[0] == full_row;
+
+		for (int32_t word = 0; word < this->words_per_row; word++)
+		{
+			if (row[word] != full_row)
+				return false;
+		}
+
+		return true;
+	}
+
+	// REMOVE ROW AND MOVE EVERYTHING ABOVE IT ONE ROW DOWN
+	void erase_row(const int32_t y);
+
+	// REMOVE ROWS removed (ASCENDING, count OF THEM) IN ONE PASS, EVERY ROW ABOVE MOVES ONCE
+	// HOWEVER MANY ROWS ARE REMOVED BELOW IT
+	// THE HASH FOLLOWS WITH ONE ROTATION PER NON-EMPTY ROW THAT MOVES
+	// COLUMN TOPS MOVE DOWN WITH THEIR ROWS, ONLY A TOP ON A REMOVED ROW IS SEARCHED FOR AGAIN
+	void erase_rows(const int32_t* removed, const int32_t count);
+
+	// TOPMOST SOLID CELL OF COLUMN x BELOW THE TOP BORDER, THE FLOOR IF THE COLUMN IS EMPTY
+	// KEPT UP TO DATE BY set AND erase_rows, EVERY CELL ABOVE IT IN THE COLUMN IS EMPTY
+	inline int32_t get_column_top(const int32_t x)
+	{
+		return this->column_tops[x];
+	}
+
+	// HIGHEST COLUMN TOP INSIDE THE BORDER, EVERY ROW ABOVE IT IS EMPTY
+	int32_t get_stack_top();
+
+	// ZOBRIST HASH OF THE SOLID CELLS INSIDE THE BORDER, SEE zobrist.hpp
+	auto get_hash() -> uint64_t;
+
+	// FIRST OF THE get_words_per_row() WORDS OF ROW y
+	inline auto get_row(const int32_t y) -> row_t*
+	{
+		return this->rows.data() + static_cast<size_t>(y + margin) * this->words_per_row;
+	}
+
+	inline auto get_empty_row() -> const row_t*
+	{
+		return this->empty_row.data();
+	}
+
+	inline auto get_words_per_row() -> int32_t
+	{
+		return this->words_per_row;
+	}
+
+	// XOR OF zobrist::column_key OF EVERY SET BIT OF WORD word OF A ROW AT LINE y
+	static inline uint64_t row_key(row_t row, const int32_t y, const int32_t word = 0)
+	{
+		uint64_t key = 0;
+		for (; row != 0; row &= row - 1)
+			key ^= zobrist::column_key(bit_utils::lowest_bit(row) + word * word_bits, y);
+
+		return key;
+	}
+
+private:
+	int32_t words_per_row = 0;
+
+	// WHAT A ROW INSIDE THE BORDER LOOKS LIKE WITHOUT ANY SOLID PIECES
+	std::vector<row_t> empty_row;
+
+	// words_per_row WORDS PER ROW, ROW AFTER ROW
+	std::vector<row_t> rows;
+
+	// bitboard::row_key OF THE SOLID CELLS OF EVERY ROW, ALL ITS WORDS, KEPT SO LINE CLEARS DON'T HAVE TO RESCAN CELLS
+	std::vector<uint64_t> row_keys;
+	uint64_t hash;
+
+	// row_key OF THE SOLID CELLS OF ROW source, ALL ITS WORDS, AS IF IT WERE AT LINE y
+	uint64_t make_row_key(const int32_t source, const int32_t y);
+
+	// SKYLINE, ONE ENTRY PER COLUMN INCLUDING THE BORDER COLUMNS
+	std::vector<int32_t> column_tops;
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include "bitboard.hpp"
+
+// SIZE OF A BOARD INCLUDING THE BORDER, THE SAME NUMBERS tetris_engine TAKES, AND THE EMPTY ROW THAT FOLLOWS
+// THE SEARCHES TAKE IT INSTEAD OF A ROW COUNT, WIDTH AND EMPTY ROW EACH
+struct board_shape
+{
+	// THE SEARCH KEEPS A ROW AND ITS MARGINS IN ONE row_t, WIDER BOARDS ARE NOT SEARCHED AT ALL
+	static constexpr int32_t max_width = bitboard::word_bits - bitboard::margin * 2;
+
+	board_shape(const int32_t width, const int32_t height) : width(width), height(height), empty_row(bitboard::make_empty_row(width))
+	{
+		assert(width <= max_width);
+	}
+
+	int32_t get_width() const
+	{
+		return this->width;
+	}
+
+	int32_t get_height() const
+	{
+		return this->height;
+	}
+
+	// ROWS INSIDE THE BORDER
+	int32_t get_row_count() const
+	{
+		return this->height - 1;
+	}
+
+	bitboard::row_t get_empty_row() const
+	{
+		return this->empty_row;
+	}
+
+private:
+	int32_t width;
+	int32_t height;
+	bitboard::row_t empty_row;
+};
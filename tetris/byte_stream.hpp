@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// LITTLE-ENDIAN FIXED WIDTH AND LEB128 VARINT ENCODING
+// USED BY REPLAYS AND ENGINE SNAPSHOTS, READERS WORK ON PLAIN MEMORY SO FILES CAN BE MAPPED
+namespace byte_stream
+{
+	template <typename T>
+	inline void write_fixed(std::vector<uint8_t>& output, const T value)
+	{
+		const auto bits = static_cast<uint64_t>(value);
+		for (size_t i = 0; i < sizeof(T); i++)
+			output.push_back(static_cast<uint8_t>(bits >> (i * 8)));
+	}
+
+	// 7 BITS PER BYTE, HIGH BIT SET WHEN MORE BYTES FOLLOW
+	inline void write_varint(std::vector<uint8_t>& output, uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			output.push_back(static_cast<uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+
+		output.push_back(static_cast<uint8_t>(value));
+	}
+
+	// BOUNDS-CHECKED CURSOR OVER A BYTE RANGE, STAYS FAILED AFTER THE FIRST OVERRUN
+	struct reader
+	{
+		reader(const uint8_t* begin, const uint8_t* end) : cursor(begin), end(end), failed(false) {}
+
+		template <typename T>
+		inline T read_fixed()
+		{
+			if (static_cast<size_t>(this->end - this->cursor) < sizeof(T))
+			{
+				this->failed = true;
+				this->cursor = this->end;
+				return T();
+			}
+
+			uint64_t bits = 0;
+			for (size_t i = 0; i < sizeof(T); i++)
+				bits |= static_cast<uint64_t>(this->cursor[i]) << (i * 8);
+
+			this->cursor += sizeof(T);
+			return static_cast<T>(bits);
+		}
+
+		inline uint64_t read_varint()
+		{
+			uint64_t value = 0;
+			for (uint32_t shift = 0; shift < 64; shift += 7)
+			{
+				if (this->cursor == this->end)
+					break;
+
+				const auto byte = *this->cursor++;
+				value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+				if ((byte & 0x80) == 0)
+					return value;
+			}
+
+			this->failed = true;
+			this->cursor = this->end;
+			return 0;
+		}
+
+		// SKIP count BYTES, RETURNS WHERE THEY START
+		inline const uint8_t* skip(const size_t count)
+		{
+			const auto start = this->cursor;
+			if (static_cast<size_t>(this->end - this->cursor) < count)
+			{
+				this->failed = true;
+				this->cursor = this->end;
+				return this->end;
+			}
+
+			this->cursor += count;
+			return start;
+		}
+
+		inline bool at_end() const
+		{
+			return this->cursor == this->end;
+		}
+
+		const uint8_t* cursor;
+		const uint8_t* end;
+		bool failed;
+	};
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+// WINDOWS CONSOLE TEXT ATTRIBUTES
+enum console_color
+{
+	dark_purple = 1,
+	dark_green,
+	dark_cyan,
+	dark_red,
+	dark_pink,
+	dark_yellow,
+	grey,
+	dark_grey,
+	dark_blue,
+	green,
+	cyan,
+	red,
+	pink,
+	yellow,
+	white
+};
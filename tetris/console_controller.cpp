@@ -1,6 +1,51 @@
 #include "console_controller.hpp"
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+std::atomic<bool> console_controller::resize_pending(false);
+
+#ifndef _WIN32
+namespace
+{
+	// WHAT THE DESTRUCTOR WOULD RESTORE, FOR CTRL-C, kill AND exit() WHICH NEVER REACH IT
+	// SET BY THE CONSTRUCTOR IN RAW MODE, CLEARED BY THE DESTRUCTOR
+	termios exit_terminal;
+	int exit_output = -1;
+	std::atomic<bool> exit_restore_pending(false);
+
+	// ONLY ASYNC-SIGNAL-SAFE CALLS, RUNS AT MOST ONCE
+	void restore_terminal_on_exit()
+	{
+		if (!exit_restore_pending.exchange(false))
+			return;
+
+		static constexpr char reset[] = "\x1b[0m\x1b[?25h\r\n";
+		if (write(exit_output, reset, sizeof(reset) - 1) < 0)
+			return;
 
-console_controller::console_controller(const HANDLE hconsole, const int32_t width, const int32_t height)
+		tcsetattr(STDIN_FILENO, TCSAFLUSH, &exit_terminal);
+	}
+
+	void restore_terminal_on_signal(const int signal_number)
+	{
+		restore_terminal_on_exit();
+
+		// DIE FROM THE SIGNAL AS IF WE HAD NEVER CAUGHT IT, THE SHELL SEES THE SAME EXIT STATUS
+		signal(signal_number, SIG_DFL);
+		raise(signal_number);
+	}
+}
+#endif
+
+#ifdef _WIN32
+console_controller::console_controller(const console_handle_t hconsole, const int32_t width, const int32_t height) : use_buffer(false), used_size(0, 0), selected_layer(0), cells_written(0), statistics{}, pressed_keys{}
 {
 	this->get_console_handle() = hconsole;
 
@@ -14,14 +59,19 @@ console_controller::console_controller(const HANDLE hconsole, const int32_t widt
 	CONSOLE_CURSOR_INFO cursor_info{ 1, false };
 	SetConsoleCursorInfo(this->get_console_handle(), &cursor_info);
 
-	// SET UP BUFFER
-	this->get_new_frame() = array2d<coordinate_data>(height, width);
-	this->get_previous_frame() = array2d<coordinate_data>(height, width);
+	// REPORT RESIZES AS INPUT RECORDS, input_reader PASSES THEM ON TO request_resize
+	const auto input_handle = GetStdHandle(STD_INPUT_HANDLE);
+	DWORD input_mode;
+	if (GetConsoleMode(input_handle, &input_mode))
+		SetConsoleMode(input_handle, input_mode | ENABLE_WINDOW_INPUT);
+
+	// SET UP BUFFER, AS MANY CELLS AS THE WINDOW SHOWS NOW
+	const auto viewport = this->query_viewport_size();
+	this->resize_frames(viewport.first, viewport.second);
 }
 
-HANDLE& console_controller::get_console_handle()
+console_controller::~console_controller()
 {
-	return this->console_handle;
 }
 
 void console_controller::set_title(const std::wstring& title)
@@ -39,6 +89,291 @@ bool console_controller::get_key_press(const int32_t vkey)
 	return result;
 }
 
+void console_controller::wait_for_key()
+{
+	getchar();
+}
+
+console_handle_t console_controller::get_input_handle()
+{
+	const auto input_handle = GetStdHandle(STD_INPUT_HANDLE);
+
+	DWORD mode;
+	return GetConsoleMode(input_handle, &mode) ? input_handle : INVALID_HANDLE_VALUE;
+}
+
+std::pair<int16_t, int16_t> console_controller::query_viewport_size()
+{
+	// THE VISIBLE WINDOW, NOT THE WHOLE SCROLLBACK BUFFER
+	CONSOLE_SCREEN_BUFFER_INFO info;
+	if (!GetConsoleScreenBufferInfo(this->get_console_handle(), &info))
+		return std::make_pair(default_viewport_width, default_viewport_height);
+
+	return std::make_pair<int16_t, int16_t>(info.srWindow.Right - info.srWindow.Left + 1, info.srWindow.Bottom - info.srWindow.Top + 1);
+}
+#else
+console_controller::console_controller(const console_handle_t hconsole, const int32_t, const int32_t) : use_buffer(false), used_size(0, 0), selected_layer(0), cells_written(0), statistics{}, pressed_keys{}, console_handle(hconsole), cursor_position(-1, -1), current_color(0), original_terminal{}, restore_terminal(false), original_resize_action{}, restore_resize_action(false), original_interrupt_action{}, original_terminate_action{}, restore_exit_actions(false)
+{
+	// RAW MODE: NO LINE BUFFERING OR ECHO, READS RETURN IMMEDIATELY
+	if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &this->original_terminal) == 0)
+	{
+		auto raw_terminal = this->original_terminal;
+		raw_terminal.c_iflag &= ~(IXON | ICRNL);
+		raw_terminal.c_lflag &= ~(ICANON | ECHO);
+		raw_terminal.c_cc[VMIN] = 0;
+		raw_terminal.c_cc[VTIME] = 0;
+
+		this->restore_terminal = tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw_terminal) == 0;
+	}
+
+	// HIDE NATIVE CURSOR AND START FROM AN EMPTY SCREEN
+	this->output_buffer.append("\x1b[?25l\x1b[2J");
+	this->flush_output();
+
+	// CTRL-C, kill AND exit() SKIP THE DESTRUCTOR, PUT THE TERMINAL BACK ON THOSE WAYS OUT TOO
+	if (this->restore_terminal)
+	{
+		exit_terminal = this->original_terminal;
+		exit_output = this->get_console_handle();
+		exit_restore_pending = true;
+
+		static const auto exit_registered = std::atexit(restore_terminal_on_exit) == 0;
+		static_cast<void>(exit_registered);
+
+		struct sigaction exit_action{};
+		exit_action.sa_handler = restore_terminal_on_signal;
+		sigemptyset(&exit_action.sa_mask);
+
+		this->restore_exit_actions =
+			sigaction(SIGINT, &exit_action, &this->original_interrupt_action) == 0 &&
+			sigaction(SIGTERM, &exit_action, &this->original_terminate_action) == 0;
+	}
+
+	// FOLLOW THE SIZE OF A REAL TERMINAL, THE HANDLER ONLY SETS A FLAG FOR update_scene
+	if (isatty(this->get_console_handle()))
+	{
+		struct sigaction resize_action{};
+		resize_action.sa_handler = [](int) { console_controller::request_resize(); };
+		sigemptyset(&resize_action.sa_mask);
+		resize_action.sa_flags = SA_RESTART;
+
+		this->restore_resize_action = sigaction(SIGWINCH, &resize_action, &this->original_resize_action) == 0;
+	}
+
+	// SET UP BUFFER
+	const auto viewport = this->query_viewport_size();
+	this->resize_frames(viewport.first, viewport.second);
+}
+
+console_controller::~console_controller()
+{
+	// RESTORED HERE, THE HANDLERS HAVE NOTHING LEFT TO DO
+	exit_restore_pending = false;
+	if (this->restore_exit_actions)
+	{
+		sigaction(SIGINT, &this->original_interrupt_action, nullptr);
+		sigaction(SIGTERM, &this->original_terminate_action, nullptr);
+	}
+
+	// RESET COLOR, SHOW CURSOR AGAIN AND LEAVE THE PROMPT BELOW THE GAME
+	this->output_buffer.append("\x1b[0m\x1b[?25h\r\n");
+	this->flush_output();
+
+	if (this->restore_terminal)
+		tcsetattr(STDIN_FILENO, TCSAFLUSH, &this->original_terminal);
+
+	if (this->restore_resize_action)
+		sigaction(SIGWINCH, &this->original_resize_action, nullptr);
+}
+
+void console_controller::set_title(const std::wstring& title)
+{
+	// OPERATING SYSTEM COMMAND, ONLY ASCII IS PASSED THROUGH
+	this->output_buffer.append("\x1b]0;");
+	for (const auto character : title)
+		this->output_buffer.push_back(character < 0x80 ? static_cast<char>(character) : '?');
+	this->output_buffer.push_back('\x07');
+
+	this->flush_output();
+}
+
+bool console_controller::get_key_press(const int32_t vkey)
+{
+	this->read_input();
+
+	const auto result = this->get_pressed_keys()[vkey];
+	this->get_pressed_keys()[vkey] = false;
+
+	return result;
+}
+
+void console_controller::wait_for_key()
+{
+	if (!this->restore_terminal)
+	{
+		getchar();
+		return;
+	}
+
+	// DROP KEYS PRESSED DURING THE GAME AND BLOCK UNTIL A NEW ONE ARRIVES
+	tcflush(STDIN_FILENO, TCIFLUSH);
+
+	pollfd descriptor{ STDIN_FILENO, POLLIN, 0 };
+	poll(&descriptor, 1, -1);
+
+	this->read_input();
+	this->get_pressed_keys().fill(false);
+}
+
+console_handle_t console_controller::get_input_handle()
+{
+	// stdin IS ONLY READ IN RAW MODE, A PIPE OR /dev/null WOULD ALWAYS LOOK READABLE
+	return this->restore_terminal ? STDIN_FILENO : -1;
+}
+
+std::pair<int16_t, int16_t> console_controller::query_viewport_size()
+{
+	winsize size;
+	if (ioctl(this->get_console_handle(), TIOCGWINSZ, &size) != 0 || size.ws_col == 0 || size.ws_row == 0)
+		return std::make_pair(default_viewport_width, default_viewport_height);
+
+	return std::make_pair<int16_t, int16_t>(size.ws_col, size.ws_row);
+}
+
+size_t console_controller::decode_key(const uint8_t* bytes, const size_t count, int32_t& key)
+{
+	key = 0;
+
+	// ARROW KEYS ARE SENT AS ESC [ A-D
+	if (bytes[0] == 0x1B && count > 2 && bytes[1] == '[')
+	{
+		switch (bytes[2])
+		{
+		case 'A': key = key_up; break;
+		case 'B': key = key_down; break;
+		case 'C': key = key_right; break;
+		case 'D': key = key_left; break;
+		}
+
+		return 3;
+	}
+
+	if (bytes[0] == 'c' || bytes[0] == 'C')
+		key = key_c;
+	else if (bytes[0] == 0x1B || bytes[0] == ' ')
+		key = bytes[0];
+
+	return 1;
+}
+
+void console_controller::read_input()
+{
+	// stdin ONLY RETURNS IMMEDIATELY IN RAW MODE
+	if (!this->restore_terminal)
+		return;
+
+	uint8_t bytes[64];
+	ssize_t count;
+	while ((count = ::read(STDIN_FILENO, bytes, sizeof(bytes))) > 0)
+	{
+		for (ssize_t i = 0; i < count;)
+		{
+			int32_t key;
+			i += decode_key(bytes + i, count - i, key);
+
+			if (key != 0)
+				this->get_pressed_keys()[key] = true;
+		}
+	}
+}
+
+void console_controller::append_position(const int16_t x, const int16_t y)
+{
+	// CURSOR IS ALREADY THERE AFTER WRITING THE CELL TO THE LEFT
+	if (this->cursor_position == std::make_pair(x, y))
+		return;
+
+	// CSI ROW ; COLUMN H, ONE-BASED
+	this->output_buffer.append("\x1b[");
+	this->output_buffer.append(std::to_string(y + 1));
+	this->output_buffer.push_back(';');
+	this->output_buffer.append(std::to_string(x + 1));
+	this->output_buffer.push_back('H');
+
+	this->cursor_position = std::make_pair(x, y);
+}
+
+void console_controller::append_color(const uint16_t color_code)
+{
+	if (color_code == this->current_color)
+		return;
+
+	// CONSOLE ATTRIBUTES ARE BLUE, GREEN, RED, INTENSITY
+	// ANSI COLORS ARE RED, GREEN, BLUE, SO BLUE AND RED ARE SWAPPED, BRIGHT ONES START AT 90
+	static constexpr std::array<std::string_view, 16> sequences =
+	{
+		"\x1b[30m", "\x1b[34m", "\x1b[32m", "\x1b[36m", "\x1b[31m", "\x1b[35m", "\x1b[33m", "\x1b[37m",
+		"\x1b[90m", "\x1b[94m", "\x1b[92m", "\x1b[96m", "\x1b[91m", "\x1b[95m", "\x1b[93m", "\x1b[97m"
+	};
+
+	this->output_buffer.append(sequences[color_code & 0xF]);
+
+	this->current_color = color_code;
+}
+
+void console_controller::append_character(const uint16_t character)
+{
+	// UTF-8 ENCODE
+	if (character < 0x80)
+	{
+		this->output_buffer.push_back(static_cast<char>(character ? character : ' '));
+	}
+	else if (character < 0x800)
+	{
+		this->output_buffer.push_back(static_cast<char>(0xC0 | (character >> 6)));
+		this->output_buffer.push_back(static_cast<char>(0x80 | (character & 0x3F)));
+	}
+	else
+	{
+		this->output_buffer.push_back(static_cast<char>(0xE0 | (character >> 12)));
+		this->output_buffer.push_back(static_cast<char>(0x80 | ((character >> 6) & 0x3F)));
+		this->output_buffer.push_back(static_cast<char>(0x80 | (character & 0x3F)));
+	}
+
+	++this->cursor_position.first;
+}
+
+void console_controller::flush_output()
+{
+	size_t offset = 0;
+	while (offset < this->output_buffer.size())
+	{
+		const auto written = ::write(this->get_console_handle(), this->output_buffer.data() + offset, this->output_buffer.size() - offset);
+		++this->get_frame_statistics().syscalls;
+
+		if (written < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			break;
+		}
+
+		offset += written;
+	}
+
+	this->get_frame_statistics().bytes_written += static_cast<uint32_t>(offset);
+
+	// KEEP CAPACITY FOR NEXT FRAME
+	this->output_buffer.clear();
+}
+#endif
+
+console_handle_t& console_controller::get_console_handle()
+{
+	return this->console_handle;
+}
+
 bool& console_controller::should_use_buffer()
 {
 	return use_buffer;
@@ -59,21 +394,99 @@ std::array<bool, 256>& console_controller::get_pressed_keys()
 	return this->pressed_keys;
 }
 
+std::vector<std::pair<int16_t, int16_t>>& console_controller::get_dirty_spans()
+{
+	return this->dirty_spans;
+}
+
+void console_controller::mark_dirty(const size_t x, const size_t y, const size_t count)
+{
+	auto& span = this->get_dirty_spans()[y];
+	span.first = std::min<int16_t>(span.first, static_cast<int16_t>(x));
+	span.second = std::max<int16_t>(span.second, static_cast<int16_t>(x + count));
+
+	this->used_size.first = std::max<int16_t>(this->used_size.first, static_cast<int16_t>(x + count));
+	this->used_size.second = std::max<int16_t>(this->used_size.second, static_cast<int16_t>(y + 1));
+}
+
+void console_controller::mark_painted(const int32_t x, const int32_t y, const int32_t count)
+{
+	// LAYER 0 IS ALWAYS COPIED WHOLE, ONLY THE LAYERS ABOVE IT ARE TRACKED
+	if (this->selected_layer == 0)
+		return;
+
+	auto& span = this->painted_spans[this->selected_layer][y];
+	span.first = std::min<int16_t>(span.first, static_cast<int16_t>(x));
+	span.second = std::max<int16_t>(span.second, static_cast<int16_t>(x + count));
+}
+
+void console_controller::unmark_painted(const int32_t x, const int32_t y, const int32_t count)
+{
+	if (this->selected_layer == 0)
+		return;
+
+	// THE CLEARED CELLS ARE EMPTY NOW, THE SPAN ONLY SHRINKS IF THEY CUT OFF ONE OF ITS ENDS
+	auto& span = this->painted_spans[this->selected_layer][y];
+	if (x <= span.first && x + count > span.first)
+		span.first = static_cast<int16_t>(std::min<int32_t>(x + count, span.second));
+	if (x < span.second && x + count >= span.second)
+		span.second = static_cast<int16_t>(std::max<int32_t>(x, span.first));
+}
+
+bool console_controller::clip(int32_t& x, const int32_t y, int32_t& count)
+{
+	if (y < 0 || y >= static_cast<int32_t>(this->get_new_frame().get_row_count()))
+		return false;
+
+	const auto first = std::max<int32_t>(x, 0);
+	const auto last = std::min<int32_t>(x + count, static_cast<int32_t>(this->get_new_frame().get_row_size()));
+	if (first >= last)
+		return false;
+
+	x = first;
+	count = last - first;
+	return true;
+}
+
+std::vector<cell_span>& console_controller::get_changed_spans()
+{
+	return this->changed_spans;
+}
+
+void console_controller::reset_dirty_spans()
+{
+	// EMPTY SPAN, first PAST THE END SO min/max IN mark_dirty WORKS WITHOUT A CHECK
+	const auto row_size = static_cast<int16_t>(this->get_new_frame().get_row_size());
+	std::fill(this->get_dirty_spans().begin(), this->get_dirty_spans().end(), std::make_pair(row_size, int16_t(0)));
+}
+
 void console_controller::clear()
 {
 	if (this->should_use_buffer())
 	{
-		for (size_t row_index = 0; row_index < this->get_new_frame().get_row_count(); row_index++)
+		// ONLY WHAT HAS BEEN DRAWN TO, THE REST OF THE BUFFER IS STILL EMPTY
+		const auto used_size = this->used_size;
+		for (int16_t row_index = 0; row_index < used_size.second; row_index++)
 		{
-			for (size_t element_index = 0; element_index < this->get_new_frame().get_row_size(); element_index++)
+			auto row = this->get_new_frame().get_row(row_index);
+			std::fill(row.begin(), row.begin() + used_size.first, coordinate_data());
+
+			for (size_t layer = 0; layer < this->layers.size(); layer++)
 			{
-				this->get_new_frame().get_element(row_index, element_index) = coordinate_data();
+				auto layer_row = this->layers[layer].get_row(row_index);
+				std::fill(layer_row.begin(), layer_row.begin() + used_size.first, coordinate_data());
+				this->painted_spans[layer][row_index] = std::make_pair(static_cast<int16_t>(this->get_new_frame().get_row_size()), int16_t(0));
 			}
+
+			this->mark_dirty(0, row_index, used_size.first);
 		}
+
+		this->cells_written += static_cast<uint32_t>(used_size.first * used_size.second);
+		this->used_size = std::make_pair<int16_t, int16_t>(0, 0);
 	}
 	else
 	{
-
+#ifdef _WIN32
 		CONSOLE_SCREEN_BUFFER_INFO buffer;
 		if (!GetConsoleScreenBufferInfo(this->get_console_handle(), &buffer))
 			return;
@@ -84,18 +497,34 @@ void console_controller::clear()
 		uint32_t written_count;
 		if (!FillConsoleOutputCharacterW(this->get_console_handle(), static_cast<TCHAR>(' '), count, null_coords, reinterpret_cast<LPDWORD>(&written_count)))
 			return;
+#else
+		// ERASE DISPLAY, CURSOR POSITION IS UNKNOWN AFTERWARDS
+		this->output_buffer.append("\x1b[2J");
+		this->flush_output();
+
+		this->cursor_position = std::make_pair<int16_t, int16_t>(-1, -1);
+#endif
 	}
 }
 void console_controller::clear(const int16_t x, const int16_t y, const int16_t width, const int16_t height)
 {
 	if (this->should_use_buffer())
 	{
-		for (size_t row_index = y; row_index < y + height; row_index++)
+		for (int32_t row_index = y; row_index < y + height; row_index++)
 		{
-			for (size_t element_index = x; element_index < x + width; element_index++)
-			{
-				this->get_new_frame().get_element(row_index, element_index) = coordinate_data();
-			}
+			int32_t first = x;
+			int32_t count = width;
+			if (!this->clip(first, row_index, count))
+				continue;
+
+			auto row = this->get_target_frame().get_row(row_index);
+			std::fill(row.begin() + first, row.begin() + first + count, coordinate_data());
+
+			if (!this->layers.empty())
+				this->unmark_painted(first, row_index, count);
+
+			this->mark_dirty(first, row_index, count);
+			this->cells_written += count;
 		}
 	}
 	else
@@ -106,34 +535,70 @@ void console_controller::clear(const int16_t x, const int16_t y, const int16_t w
 	}
 }
 
-void console_controller::draw(const int16_t x, const int16_t y, const std::string& message, const uint16_t color_code)
+void console_controller::draw(const int16_t x, const int16_t y, const std::string_view message, const uint16_t color_code)
 {
 	if (this->should_use_buffer())
 	{
-		for (size_t i = 0; i < message.size(); i++)
+		int32_t first = x;
+		int32_t count = static_cast<int32_t>(message.size());
+		if (!this->clip(first, y, count))
+			return;
+
+		auto& frame = this->get_target_frame();
+		for (int32_t i = 0; i < count; i++)
 		{
-			this->get_new_frame().get_element(y, x + i) = coordinate_data(message[i], color_code);
+			frame.get_element(y, first + i) = coordinate_data(static_cast<uint8_t>(message[first - x + i]), color_code);
 		}
+
+		if (!this->layers.empty())
+			this->mark_painted(first, y, count);
+
+		this->mark_dirty(first, y, count);
+		this->cells_written += count;
 	}
 	else
 	{
+#ifdef _WIN32
 		// SET COLOR
 		if (color_code)
 			SetConsoleTextAttribute(this->get_console_handle(), color_code);
 
 		// SET POSITION AND WRITE
 		this->set_position(x, y);
-		std::printf("%s", message.c_str());
+		std::printf("%.*s", static_cast<int>(message.size()), message.data());
+#else
+		// SET COLOR
+		if (color_code)
+			this->append_color(color_code);
+
+		// SET POSITION AND WRITE
+		this->append_position(x, y);
+		for (const auto character : message)
+			this->append_character(static_cast<uint8_t>(character));
+
+		this->flush_output();
+#endif
 	}
 }
 void console_controller::draw(const int16_t x, const int16_t y, const uint16_t character, const uint16_t color_code)
 {
 	if (this->should_use_buffer())
 	{
-		this->get_new_frame().get_element(y, x) = coordinate_data(character, color_code);
+		int32_t first = x;
+		int32_t count = 1;
+		if (!this->clip(first, y, count))
+			return;
+
+		this->get_target_frame().get_element(y, x) = coordinate_data(character, color_code);
+		if (!this->layers.empty())
+			this->mark_painted(x, y, 1);
+
+		this->mark_dirty(x, y, 1);
+		++this->cells_written;
 	}
 	else
 	{
+#ifdef _WIN32
 		// SET COLOR
 		if (color_code)
 			SetConsoleTextAttribute(this->get_console_handle(), color_code);
@@ -141,6 +606,17 @@ void console_controller::draw(const int16_t x, const int16_t y, const uint16_t c
 		// SET POSITION AND WRITE
 		this->set_position(x, y);
 		std::printf("%lc", character);
+#else
+		// SET COLOR
+		if (color_code)
+			this->append_color(color_code);
+
+		// SET POSITION AND WRITE
+		this->append_position(x, y);
+		this->append_character(character);
+
+		this->flush_output();
+#endif
 	}
 }
 
@@ -148,16 +624,23 @@ uint16_t console_controller::read(const int16_t x, const int16_t y)
 {
 	if (this->should_use_buffer())
 	{
-		return this->get_new_frame().get_element(y, x).get_character();
+		int32_t first = x;
+		int32_t count = 1;
+		return this->clip(first, y, count) ? this->get_target_frame().get_element(y, x).get_character() : 0;
 	}
 	else
 	{
+#ifdef _WIN32
 		CHAR_INFO buffer;
 		SMALL_RECT rectangle{ x, y, x, y };
 		const COORD coords{ x, y };
 		const COORD size{ 1,1 };
 
 		return ReadConsoleOutput(this->get_console_handle(), &buffer, size, coords, &rectangle) ? buffer.Char.UnicodeChar : L' ';
+#else
+		// A TERMINAL CAN'T BE READ BACK
+		return L' ';
+#endif
 	}
 }
 
@@ -165,13 +648,26 @@ void console_controller::fill_horizontal(const int16_t x, const int16_t y, const
 {
 	if (this->should_use_buffer())
 	{
-		for (size_t i = 0; i < count; i++)
+		int32_t first = x;
+		int32_t clipped_count = count;
+		if (!this->clip(first, y, clipped_count))
+			return;
+
+		auto& frame = this->get_target_frame();
+		for (int32_t i = 0; i < clipped_count; i++)
 		{
-			this->get_new_frame().get_element(y, x + i) = coordinate_data(character, color_code);
+			frame.get_element(y, first + i) = coordinate_data(character, color_code);
 		}
+
+		if (!this->layers.empty())
+			this->mark_painted(first, y, clipped_count);
+
+		this->mark_dirty(first, y, clipped_count);
+		this->cells_written += clipped_count;
 	}
 	else
 	{
+#ifdef _WIN32
 		CONSOLE_SCREEN_BUFFER_INFO buffer;
 		if (!GetConsoleScreenBufferInfo(this->get_console_handle(), &buffer))
 			return;
@@ -183,6 +679,48 @@ void console_controller::fill_horizontal(const int16_t x, const int16_t y, const
 
 		if (color_code)
 			FillConsoleOutputAttribute(this->get_console_handle(), color_code, count, coords, reinterpret_cast<LPDWORD>(&written_count));
+#else
+		if (color_code)
+			this->append_color(color_code);
+
+		this->append_position(x, y);
+		for (size_t i = 0; i < count; i++)
+			this->append_character(character);
+
+		this->flush_output();
+#endif
+	}
+}
+
+void console_controller::blit(const int16_t x, const int16_t y, const coordinate_data* cells, const int16_t width, const int16_t height, const size_t stride)
+{
+	for (int16_t row_index = 0; row_index < height; row_index++)
+		this->blit_row(x, y + row_index, cells + row_index * stride, width);
+}
+
+void console_controller::blit_row(const int16_t x, const int16_t y, const coordinate_data* cells, const int16_t count)
+{
+	if (this->should_use_buffer())
+	{
+		int32_t first = x;
+		int32_t clipped_count = count;
+		if (!this->clip(first, y, clipped_count))
+			return;
+
+		// ONE COPY OF THE PART THAT FITS
+		const auto source = cells + (first - x);
+		std::copy(source, source + clipped_count, this->get_target_frame().get_row(y).begin() + first);
+
+		if (!this->layers.empty())
+			this->mark_painted(first, y, clipped_count);
+
+		this->mark_dirty(first, y, clipped_count);
+		this->cells_written += clipped_count;
+	}
+	else
+	{
+		for (int16_t index = 0; index < count; index++)
+			this->draw(x + index, y, cells[index].get_character() ? cells[index].get_character() : ' ', cells[index].get_color());
 	}
 }
 
@@ -191,27 +729,225 @@ void console_controller::update_scene()
 	if (!this->should_use_buffer())
 		return;
 
+	this->get_frame_statistics() = frame_statistics();
+
+	// TERMINAL CHANGED SIZE, START OVER FROM AN EMPTY SCREEN WITH EVERYTHING THAT STILL FITS
+	if (resize_pending.exchange(false, std::memory_order_relaxed))
+	{
+		const auto viewport = this->query_viewport_size();
+		this->resize_frames(viewport.first, viewport.second);
+
+#ifdef _WIN32
+		CONSOLE_SCREEN_BUFFER_INFO info;
+		DWORD written;
+		if (GetConsoleScreenBufferInfo(this->get_console_handle(), &info))
+			FillConsoleOutputCharacterW(this->get_console_handle(), L' ', info.dwSize.X * info.dwSize.Y, COORD{ 0, 0 }, &written);
+#else
+		this->output_buffer.append("\x1b[2J");
+		this->cursor_position = std::make_pair<int16_t, int16_t>(-1, -1);
+#endif
+	}
+
+	this->get_frame_statistics().cells_written = this->cells_written;
+	this->cells_written = 0;
+	this->get_changed_spans().clear();
+
+	// FIND THE RUNS THAT CHANGED, ONLY LOOKING AT CELLS WRITTEN THIS FRAME
+	const auto row_count = static_cast<int16_t>(this->get_new_frame().get_row_count());
+	for (int16_t row_index = 0; row_index < row_count; row_index++)
+	{
+		const auto span = this->get_dirty_spans()[row_index];
+		if (span.first >= span.second)
+			continue;
+
+		this->get_frame_statistics().cells_scanned += span.second - span.first;
+
+		// MERGE THE LAYERS OF THE WRITTEN CELLS INTO new_frame
+		if (!this->layers.empty())
+			this->composite_row(row_index, span.first, span.second);
+
+		const auto new_row = reinterpret_cast<const uint32_t*>(this->get_new_frame().get_row(row_index).begin());
+		const auto previous_row = reinterpret_cast<const uint32_t*>(this->get_previous_frame().get_row(row_index).begin());
+		this->differ.diff_row(new_row, previous_row, row_index, span.first, span.second, this->get_changed_spans());
+
+		// BRING PREVIOUS FRAME UP TO DATE, CELLS OUTSIDE THE SPAN ARE ALREADY EQUAL
+		this->get_previous_frame().copy_range(this->get_new_frame(), row_index, span.first, span.second - span.first);
+	}
+
 	// DRAW ONLY UPDATED SQUARES
-	for (int16_t row_index = 0; row_index < this->get_new_frame().get_row_count(); row_index++)
+	for (auto& changed : this->get_changed_spans())
+		this->emit_span(changed);
+
+#ifndef _WIN32
+	// WHOLE FRAME IN A SINGLE write
+	this->flush_output();
+#endif
+
+	this->reset_dirty_spans();
+}
+
+std::pair<int16_t, int16_t> console_controller::get_viewport_size()
+{
+	return std::make_pair(static_cast<int16_t>(this->get_new_frame().get_row_size()), static_cast<int16_t>(this->get_new_frame().get_row_count()));
+}
+
+void console_controller::request_resize()
+{
+	resize_pending.store(true, std::memory_order_relaxed);
+}
+
+void console_controller::resize_frames(const int16_t width, const int16_t height)
+{
+	// KEEP THE PART OF EVERY LAYER THAT STILL FITS
+	const auto resized = [width, height](array2d<coordinate_data>& frame)
+	{
+		auto result = array2d<coordinate_data>(height, width);
+		const auto rows = std::min<size_t>(height, frame.get_row_count());
+		const auto columns = std::min<size_t>(width, frame.get_row_size());
+		for (size_t row_index = 0; row_index < rows; row_index++)
+			std::copy(frame.get_row(row_index).begin(), frame.get_row(row_index).begin() + columns, result.get_row(row_index).begin());
+
+		frame = std::move(result);
+	};
+
+	resized(this->get_new_frame());
+	for (auto& layer : this->layers)
+		resized(layer);
+
+	// CUT WHAT WAS PAINTED TO THE NEW WIDTH, A SPAN WITH first AT OR PAST second IS EMPTY
+	for (auto& spans : this->painted_spans)
+	{
+		spans.resize(height, std::make_pair(width, int16_t(0)));
+		for (auto& span : spans)
+			span.second = std::min(span.second, width);
+	}
+
+	// THE TERMINAL MAY HAVE REFLOWED OR CUT WHAT WAS ON IT, ASSUME IT IS EMPTY AND REDRAW WHAT IS USED
+	this->get_previous_frame() = array2d<coordinate_data>(height, width);
+	this->get_dirty_spans().resize(height);
+	this->reset_dirty_spans();
+
+	this->used_size.first = std::min(this->used_size.first, width);
+	this->used_size.second = std::min(this->used_size.second, height);
+	for (int16_t row_index = 0; row_index < this->used_size.second; row_index++)
+		this->mark_dirty(0, row_index, this->used_size.first);
+
+}
+
+void console_controller::set_layer_count(const uint8_t count)
+{
+	// A SINGLE LAYER IS new_frame ITSELF
+	this->layers.clear();
+	this->painted_spans.clear();
+	if (count > 1)
 	{
-		for (int16_t element_index = 0; element_index < this->get_new_frame().get_row_size(); element_index++)
+		const auto row_count = this->get_new_frame().get_row_count();
+		const auto row_size = static_cast<int16_t>(this->get_new_frame().get_row_size());
+		this->layers.assign(count, array2d<coordinate_data>(row_count, row_size));
+		this->painted_spans.assign(count, std::vector<std::pair<int16_t, int16_t>>(row_count, std::make_pair(row_size, int16_t(0))));
+	}
+
+	this->selected_layer = 0;
+}
+
+void console_controller::select_layer(const uint8_t layer)
+{
+	if (layer < this->layers.size())
+		this->selected_layer = layer;
+}
+
+array2d<coordinate_data>& console_controller::get_target_frame()
+{
+	return this->layers.empty() ? this->get_new_frame() : this->layers[this->selected_layer];
+}
+
+void console_controller::composite_row(const int16_t row_index, const int16_t first, const int16_t last)
+{
+	// BOTTOM LAYER AS IT IS, EVERY LAYER ABOVE ONLY WHERE IT ISN'T EMPTY (0)
+	// AND ONLY WHERE IT HAS BEEN PAINTED ON THIS ROW, EVERYWHERE ELSE IT IS SEE-THROUGH
+	const auto frame_row = reinterpret_cast<uint32_t*>(this->get_new_frame().get_row(row_index).begin());
+	const auto bottom_row = reinterpret_cast<const uint32_t*>(this->layers.front().get_row(row_index).begin());
+
+	// ALL ONES WHERE upper ISN'T EMPTY, A SELECT WITHOUT A BRANCH PER CELL
+	const auto merge = [](const uint32_t upper, const uint32_t lower)
+	{
+		const auto opaque = 0u - static_cast<uint32_t>(upper != 0);
+		return (upper & opaque) | (lower & ~opaque);
+	};
+
+	auto merged = false;
+	for (size_t layer = 1; layer < this->layers.size(); layer++)
+	{
+		const auto painted = this->painted_spans[layer][row_index];
+		const auto layer_first = std::max(first, painted.first);
+		const auto layer_last = std::min(last, painted.second);
+		if (layer_first >= layer_last)
+			continue;
+
+		const auto layer_row = reinterpret_cast<const uint32_t*>(this->layers[layer].get_row(row_index).begin());
+		if (merged)
 		{
-			auto& new_data = this->get_new_frame().get_element(row_index, element_index);
-			auto& previous_data = this->get_previous_frame().get_element(row_index, element_index);
+			for (auto index = layer_first; index < layer_last; index++)
+				frame_row[index] = merge(layer_row[index], frame_row[index]);
 
-			// DO NOT UPDATE CHARACTER
-			if (new_data == previous_data)
-				continue;
+			continue;
+		}
+
+		// THE LOWEST PAINTED LAYER IS MERGED IN THE SAME PASS THAT COPIES THE BOTTOM ONE
+		for (auto index = first; index < layer_first; index++)
+			frame_row[index] = bottom_row[index];
+		for (auto index = layer_first; index < layer_last; index++)
+			frame_row[index] = merge(layer_row[index], bottom_row[index]);
+		for (auto index = layer_last; index < last; index++)
+			frame_row[index] = bottom_row[index];
+
+		merged = true;
+	}
+
+	if (!merged)
+		std::copy(bottom_row + first, bottom_row + last, frame_row + first);
+
+	this->get_frame_statistics().cells_composited += last - first;
+}
+
+void console_controller::emit_span(const cell_span& span)
+{
+	this->get_frame_statistics().cells_emitted += span.last - span.first;
 
-			if (new_data.get_color())
-				SetConsoleTextAttribute(this->get_console_handle(), new_data.get_color());
+	auto row = this->get_new_frame().get_row(span.row);
 
-			this->set_position(element_index, row_index);
-			std::printf("%lc", new_data.get_character());
+#ifdef _WIN32
+	// ONE CALL FOR THE POSITION OF THE RUN, THEN ONE PER CHARACTER AND ONE PER COLOR CHANGE
+	this->set_position(span.first, span.row);
+	++this->get_frame_statistics().syscalls;
+
+	uint16_t current_color = 0;
+	for (auto index = span.first; index < span.last; index++)
+	{
+		const auto cell = row[index];
+		if (cell.get_color() && cell.get_color() != current_color)
+		{
+			SetConsoleTextAttribute(this->get_console_handle(), cell.get_color());
+			current_color = cell.get_color();
+			++this->get_frame_statistics().syscalls;
 		}
+
+		std::printf("%lc", cell.get_character());
+		++this->get_frame_statistics().syscalls;
+		++this->get_frame_statistics().bytes_written;
 	}
+#else
+	// ONE CURSOR MOVE FOR THE WHOLE RUN, COLOR ONLY WHEN IT CHANGES
+	this->append_position(span.first, span.row);
+	for (auto index = span.first; index < span.last; index++)
+	{
+		const auto cell = row[index];
+		if (cell.get_color())
+			this->append_color(cell.get_color());
 
-	this->get_previous_frame() = this->get_new_frame();
+		this->append_character(cell.get_character());
+	}
+#endif
 }
 
 void console_controller::toggle_buffer_render(bool toggle)
@@ -219,15 +955,29 @@ void console_controller::toggle_buffer_render(bool toggle)
 	this->use_buffer = toggle;
 }
 
+frame_statistics& console_controller::get_frame_statistics()
+{
+	return this->statistics;
+}
+
 void console_controller::set_position(const int16_t x, const int16_t y)
 {
+#ifdef _WIN32
 	SetConsoleCursorPosition(this->get_console_handle(), COORD{ x, y });
+#else
+	this->append_position(x, y);
+	this->flush_output();
+#endif
 }
 
 std::pair<int16_t, int16_t> console_controller::get_position()
 {
+#ifdef _WIN32
 	CONSOLE_SCREEN_BUFFER_INFO info;
 	GetConsoleScreenBufferInfo(this->get_console_handle(), &info);
 
 	return std::make_pair(info.dwCursorPosition.X, info.dwCursorPosition.Y);
+#else
+	return this->cursor_position;
+#endif
 }
@@ -1,53 +1,122 @@
 #pragma once
+#ifdef _WIN32
 #include <Windows.h>
+#else
+#include <signal.h>
+#include <termios.h>
+#endif
 #include <cstdint>
 #include <array>
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <vector>
 #include "array2d.hpp"
 #include "coordinate_data.hpp"
+#include "frame_differ.hpp"
+#include "console_color.hpp"
 
-enum console_color
+#ifdef _WIN32
+using console_handle_t = HANDLE;
+#else
+// FILE DESCRIPTOR OF THE TERMINAL, OUTPUT IS WRITTEN AS VT ESCAPE SEQUENCES
+using console_handle_t = int;
+#endif
+
+// KEYS READ BY get_key_press, SAME VALUES AS WINDOWS VIRTUAL KEY CODES
+enum console_key
 {
-	dark_purple = 1,
-	dark_green,
-	dark_cyan,
-	dark_red,
-	dark_pink,
-	dark_yellow,
-	grey,
-	dark_grey,
-	dark_blue,
-	green,
-	cyan,
-	red,
-	pink,
-	yellow,
-	white
+	key_escape = 0x1B,
+	key_space = 0x20,
+	key_left = 0x25,
+	key_up,
+	key_right,
+	key_down,
+	key_c = 0x43
 };
 
+// OUTPUT COST OF THE LAST update_scene
+struct frame_statistics
+{
+	uint32_t bytes_written = 0;
+	uint32_t syscalls = 0;
+	uint32_t cells_scanned = 0;
+	uint32_t cells_emitted = 0;
+
+	// CELLS SET BY draw, clear AND fill_horizontal SINCE THE update_scene BEFORE
+	uint32_t cells_written = 0;
 
+	// CELLS WHOSE LAYERS WERE MERGED AGAIN, ONLY WITH MORE THAN ONE LAYER
+	uint32_t cells_composited = 0;
+};
 
+// THE BUFFER IS AS LARGE AS THE VISIBLE TERMINAL, ASKED AT START AND AGAIN AFTER EVERY RESIZE
+// ANYTHING DRAWN OUTSIDE OF IT IS CLIPPED
 class console_controller
 {
 public:
-	console_controller(const HANDLE hconsole, const int32_t width, const int32_t height);
+	// WINDOWS: width AND height ARE THE WINDOW SIZE IN PIXELS, THE BUFFER FOLLOWS THE CELLS THAT FIT IN IT
+	// WITHOUT A TERMINAL (A FILE OR /dev/null) THE BUFFER IS default_viewport_width x default_viewport_height
+	console_controller(const console_handle_t hconsole, const int32_t width, const int32_t height);
+	~console_controller();
+
+	// OWNS THE TERMINAL STATE, SO IT CAN'T BE COPIED
+	console_controller(const console_controller&) = delete;
+	console_controller& operator=(const console_controller&) = delete;
 
 	// GENERAL
 	void set_title(const std::wstring& title);
 
+	static constexpr int16_t default_viewport_width = 80;
+	static constexpr int16_t default_viewport_height = 25;
+
+	// COLUMNS AND ROWS OF THE BUFFER
+	std::pair<int16_t, int16_t> get_viewport_size();
+
+	// THE TERMINAL CHANGED SIZE, THE NEXT update_scene RESIZES THE BUFFER AND REDRAWS ALL OF IT
+	// SAFE TO CALL FROM A SIGNAL HANDLER OR ANOTHER THREAD. POSIX CALLS IT ON SIGWINCH,
+	// WINDOWS FROM input_reader WHEN THE CONSOLE REPORTS A NEW BUFFER SIZE
+	static void request_resize();
+
 	// CONTROL
 	bool get_key_press(const int32_t vkey);
+	void wait_for_key();
+
+	// HANDLE KEY EVENTS CAN BE READ FROM WHILE THE GAME RUNS, SEE input_reader
+	// INVALID (-1 OR INVALID_HANDLE_VALUE) WITHOUT AN INTERACTIVE TERMINAL
+	console_handle_t get_input_handle();
+
+#ifndef _WIN32
+	// DECODE THE KEY AT THE START OF bytes READ FROM A RAW TERMINAL, RETURNS HOW MANY BYTES IT TOOK
+	// key IS 0 FOR BYTES THAT AREN'T ONE OF console_key
+	static size_t decode_key(const uint8_t* bytes, const size_t count, int32_t& key);
+#endif
 
 	// FILLING
+	// clear() EMPTIES EVERY LAYER, EVERYTHING ELSE ONLY TOUCHES THE SELECTED ONE
 	void clear();
 	void clear(const int16_t x, const int16_t y, const int16_t width, const int16_t height);
-	void draw(const int16_t x, const int16_t y, const std::string& message, const uint16_t color_code = 0);
+	void draw(const int16_t x, const int16_t y, const std::string_view message, const uint16_t color_code = 0);
 	void draw(const int16_t x, const int16_t y, const uint16_t character, const uint16_t color_code = 0);
 	uint16_t read(const int16_t x, const int16_t y);
 	void fill_horizontal(const int16_t x, const int16_t y, const uint16_t character, const uint16_t count, const uint16_t color_code = 0);
 
+	// COPY A width x height BLOCK OF CELLS TO x, y, ROW AFTER ROW, ROWS OF cells ARE stride CELLS APART
+	// EMPTY CELLS ARE COPIED TOO, SO WHAT THE BLOCK COVERS NEEDS NO clear BEFORE
+	void blit(const int16_t x, const int16_t y, const coordinate_data* cells, const int16_t width, const int16_t height, const size_t stride);
+	void blit_row(const int16_t x, const int16_t y, const coordinate_data* cells, const int16_t count);
+
 	// BUFFER
 	void update_scene();
 	void toggle_buffer_render(bool toggle);
+	frame_statistics& get_frame_statistics();
+
+	// LAYERS OF THE BUFFER, 0 AT THE BOTTOM. A CELL SHOWS THE TOPMOST LAYER THAT ISN'T EMPTY THERE
+	// CLEARING A CELL OF A LAYER ABOVE 0 MAKES IT SEE-THROUGH, DRAW ' ' TO HIDE WHAT IS BELOW
+	// update_scene ONLY MERGES THE CELLS WRITTEN SINCE THE LAST ONE, SO A LAYER THAT IS DRAWN ONCE,
+	// LIKE A BORDER, COSTS NOTHING AFTERWARDS. ONE LAYER (THE DEFAULT) DRAWS STRAIGHT INTO THE FRAME
+	void set_layer_count(const uint8_t count);
+	void select_layer(const uint8_t layer);
 
 	// POSITION
 	void set_position(const int16_t x, const int16_t y);
@@ -62,11 +131,81 @@ private:
 	array2d<coordinate_data>& get_new_frame();
 	array2d<coordinate_data>& get_previous_frame();
 
+	// VIEWPORT
+	static std::atomic<bool> resize_pending;
+	std::pair<int16_t, int16_t> query_viewport_size();
+	void resize_frames(const int16_t width, const int16_t height);
+
+	// CUT [x, x + count) ON ROW y DOWN TO THE BUFFER, FALSE IF NOTHING IS LEFT
+	bool clip(int32_t& x, const int32_t y, int32_t& count);
+
+	// COLUMNS AND ROWS THAT HAVE BEEN DRAWN TO SINCE THE LAST clear(), THE ONLY PART IT HAS TO EMPTY
+	std::pair<int16_t, int16_t> used_size;
+
+	// EMPTY WITH A SINGLE LAYER, draw AND clear WRITE TO new_frame THEN
+	std::vector<array2d<coordinate_data>> layers;
+	uint8_t selected_layer;
+	array2d<coordinate_data>& get_target_frame();
+	void composite_row(const int16_t row_index, const int16_t first, const int16_t last);
+
+	// PER LAYER, COLUMNS [first, second) OF EACH ROW THAT MAY HOLD NON-EMPTY CELLS. GROWN BY DRAWING,
+	// SHRUNK BY CLEARING ONE END OF IT. composite_row ONLY MERGES A LAYER ABOVE 0 WHERE THIS MEETS THE DIRTY SPAN,
+	// SO A LAYER THAT IS SEE-THROUGH ON A ROW, LIKE THE HUD NEXT TO THE BOARD, COSTS NOTHING THERE
+	std::vector<std::vector<std::pair<int16_t, int16_t>>> painted_spans;
+	void mark_painted(const int32_t x, const int32_t y, const int32_t count);
+	void unmark_painted(const int32_t x, const int32_t y, const int32_t count);
+	uint32_t cells_written;
+
+	// COLUMNS [first, second) OF EACH ROW WRITTEN SINCE LAST update_scene
+	// ONLY THESE ARE COMPARED AGAINST previous_frame
+	std::vector<std::pair<int16_t, int16_t>> dirty_spans;
+	std::vector<std::pair<int16_t, int16_t>>& get_dirty_spans();
+	void mark_dirty(const size_t x, const size_t y, const size_t count);
+	void reset_dirty_spans();
+
+	// RUNS OF CELLS THAT DIFFER FROM previous_frame, FOUND BY differ AND WRITTEN OUT RUN BY RUN
+	frame_differ differ;
+	std::vector<cell_span> changed_spans;
+	std::vector<cell_span>& get_changed_spans();
+	void emit_span(const cell_span& span);
+
+	// STATISTICS
+	frame_statistics statistics;
+
 	// INPUT
+	// WINDOWS: STATE OF EACH KEY LAST CALL, POSIX: KEYS READ BUT NOT YET REPORTED
 	std::array<bool, 256> pressed_keys;
 	std::array<bool, 256>& get_pressed_keys();
 
 	// HANDLE
-	HANDLE console_handle;
-	HANDLE& get_console_handle();
-};
\ No newline at end of file
+	console_handle_t console_handle;
+	console_handle_t& get_console_handle();
+
+#ifndef _WIN32
+	// VT OUTPUT, REUSED EVERY FRAME AND FLUSHED WITH A SINGLE write
+	std::string output_buffer;
+	std::pair<int16_t, int16_t> cursor_position;
+	uint16_t current_color;
+
+	void append_position(const int16_t x, const int16_t y);
+	void append_color(const uint16_t color_code);
+	void append_character(const uint16_t character);
+	void flush_output();
+
+	// RAW MODE, RESTORED ON DESTRUCTION
+	termios original_terminal;
+	bool restore_terminal;
+
+	// SIGWINCH HANDLER BEFORE OURS, ONLY REPLACED FOR A TERMINAL
+	struct sigaction original_resize_action;
+	bool restore_resize_action;
+
+	// SIGINT AND SIGTERM HANDLERS BEFORE OURS, OURS PUT THE TERMINAL BACK BEFORE THE PROCESS DIES
+	// ONLY REPLACED IN RAW MODE
+	struct sigaction original_interrupt_action;
+	struct sigaction original_terminate_action;
+	bool restore_exit_actions;
+
+	void read_input();
+#endif
+};
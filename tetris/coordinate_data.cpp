@@ -1,11 +0,0 @@
-#include "coordinate_data.hpp"
-
-uint16_t& coordinate_data::get_character()
-{
-	return this->character;
-}
-
-uint16_t& coordinate_data::get_color()
-{
-	return this->color_code;
-}
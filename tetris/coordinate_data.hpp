@@ -1,20 +1,34 @@
 #pragma once
 #include <cstdint>
 
+// ONE CELL OF A FRAME PACKED INTO 32 BITS, CHARACTER IN THE LOW HALF AND COLOR IN THE HIGH HALF
+// ROWS OF CELLS ARE PLAIN ARRAYS OF uint32_t, SO TWO FRAMES CAN BE COMPARED SEVERAL CELLS AT A TIME
 struct coordinate_data
 {
-	uint16_t& get_character();
-	uint16_t& get_color();
+	// READ FOR EVERY CELL OF EVERY FRAME, SO THEY LIVE HERE WHERE THEY CAN BE INLINED
+	uint16_t get_character() const
+	{
+		return static_cast<uint16_t>(this->packed);
+	}
+	uint16_t get_color() const
+	{
+		return static_cast<uint16_t>(this->packed >> 16);
+	}
+	uint32_t get_packed() const
+	{
+		return this->packed;
+	}
 
 	coordinate_data() = default;
-	coordinate_data(const uint16_t new_character, const uint16_t new_color_code) : character(new_character), color_code(new_color_code) {}
+	coordinate_data(const uint16_t new_character, const uint16_t new_color_code) : packed(static_cast<uint32_t>(new_character) | (static_cast<uint32_t>(new_color_code) << 16)) {}
 
-	bool operator==(const coordinate_data& other)
+	bool operator==(const coordinate_data& other) const
 	{
-		return this->character == other.character && this->color_code == other.color_code;
+		return this->packed == other.packed;
 	}
 
 private:
-	uint16_t character;
-	uint16_t color_code;
-};
\ No newline at end of file
+	uint32_t packed;
+};
+
+static_assert(sizeof(coordinate_data) == sizeof(uint32_t), "frame_differ reads rows of coordinate_data as uint32_t");
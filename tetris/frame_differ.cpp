@@ -0,0 +1,214 @@
+#include "frame_differ.hpp"
+#include "bit_utils.hpp"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define FRAME_DIFFER_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC EMITS ANY INTRINSIC, GCC AND CLANG ONLY INSIDE FUNCTIONS MARKED FOR THE INSTRUCTION SET
+#if defined(FRAME_DIFFER_X86) && !defined(_MSC_VER)
+#define FRAME_DIFFER_TARGET(isa) __attribute__((target(isa)))
+#else
+#define FRAME_DIFFER_TARGET(isa)
+#endif
+
+namespace
+{
+	// TURN A MASK OF CHANGED CELLS (BIT i IS CELL base + i) INTO SPANS
+	// open_start IS THE FIRST CELL OF A RUN STILL OPEN FROM THE BLOCK BEFORE, -1 IF NONE
+	inline void add_runs(const uint64_t mask, const int32_t width, const int16_t base, const int16_t row, int32_t& open_start, std::vector<cell_span>& spans)
+	{
+		// EVERY SET BIT IS A CELL WHERE A RUN STARTS OR ENDS
+		const auto width_mask = width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+		auto transitions = (mask ^ ((mask << 1) | (open_start >= 0 ? 1 : 0))) & width_mask;
+
+		for (; transitions != 0; transitions &= transitions - 1)
+		{
+			const auto cell = static_cast<int16_t>(base + bit_utils::lowest_bit(transitions));
+			if (open_start < 0)
+			{
+				open_start = cell;
+			}
+			else
+			{
+				spans.push_back({ row, static_cast<int16_t>(open_start), cell });
+				open_start = -1;
+			}
+		}
+	}
+
+	// CELLS [index, last) ONE AT A TIME, CLOSES THE RUN STILL OPEN AT last
+	inline void diff_tail(const uint32_t* new_row, const uint32_t* previous_row, const int16_t row, int32_t index, const int16_t last, int32_t& open_start, std::vector<cell_span>& spans)
+	{
+		for (; index < last; index++)
+		{
+			const auto changed = new_row[index] != previous_row[index];
+			if (changed && open_start < 0)
+			{
+				open_start = index;
+			}
+			else if (!changed && open_start >= 0)
+			{
+				spans.push_back({ row, static_cast<int16_t>(open_start), static_cast<int16_t>(index) });
+				open_start = -1;
+			}
+		}
+
+		if (open_start >= 0)
+			spans.push_back({ row, static_cast<int16_t>(open_start), last });
+	}
+
+	void diff_row_scalar(const uint32_t* new_row, const uint32_t* previous_row, const int16_t row, const int16_t first, const int16_t last, std::vector<cell_span>& spans)
+	{
+		int32_t open_start = -1;
+		diff_tail(new_row, previous_row, row, first, last, open_start, spans);
+	}
+
+#ifdef FRAME_DIFFER_X86
+	// CELLS [index, index + 8), THE SSE2 LOOP AND THE LAST HALF BLOCK OF AN AVX2 ROW
+	FRAME_DIFFER_TARGET("sse2")
+	inline void diff_block_sse2(const uint32_t* new_row, const uint32_t* previous_row, const int16_t row, const int32_t index, int32_t& open_start, std::vector<cell_span>& spans)
+	{
+		// A LANE OF THE COMPARE IS ALL ONES WHERE THE CELL IS UNCHANGED, movemask TAKES ONE BIT PER LANE
+		const auto equal_low = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(new_row + index)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(previous_row + index)));
+		const auto equal_high = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(new_row + index + 4)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(previous_row + index + 4)));
+		const auto equal = _mm_movemask_ps(_mm_castsi128_ps(equal_low)) | (_mm_movemask_ps(_mm_castsi128_ps(equal_high)) << 4);
+
+		// NOTHING CHANGED AND NO RUN TO CONTINUE, BY FAR THE MOST COMMON CASE
+		if (equal == 0xFF && open_start < 0)
+			return;
+
+		add_runs(static_cast<uint64_t>(~equal & 0xFF), 8, static_cast<int16_t>(index), row, open_start, spans);
+	}
+
+	FRAME_DIFFER_TARGET("sse2")
+	void diff_row_sse2(const uint32_t* new_row, const uint32_t* previous_row, const int16_t row, const int16_t first, const int16_t last, std::vector<cell_span>& spans)
+	{
+		int32_t open_start = -1;
+		int32_t index = first;
+
+		for (; index + 8 <= last; index += 8)
+			diff_block_sse2(new_row, previous_row, row, index, open_start, spans);
+
+		diff_tail(new_row, previous_row, row, index, last, open_start, spans);
+	}
+
+	FRAME_DIFFER_TARGET("avx2")
+	void diff_row_avx2(const uint32_t* new_row, const uint32_t* previous_row, const int16_t row, const int16_t first, const int16_t last, std::vector<cell_span>& spans)
+	{
+		int32_t open_start = -1;
+		int32_t index = first;
+
+		for (; index + 16 <= last; index += 16)
+		{
+			const auto equal_low = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(new_row + index)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(previous_row + index)));
+			const auto equal_high = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(new_row + index + 8)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(previous_row + index + 8)));
+			const auto equal = _mm256_movemask_ps(_mm256_castsi256_ps(equal_low)) | (_mm256_movemask_ps(_mm256_castsi256_ps(equal_high)) << 8);
+
+			if (equal == 0xFFFF && open_start < 0)
+				continue;
+
+			add_runs(static_cast<uint64_t>(~equal & 0xFFFF), 16, static_cast<int16_t>(index), row, open_start, spans);
+		}
+
+		// UP TO 15 CELLS LEFT, HALF A BLOCK AT ONCE BEFORE GOING CELL BY CELL
+		if (index + 8 <= last)
+		{
+			diff_block_sse2(new_row, previous_row, row, index, open_start, spans);
+			index += 8;
+		}
+
+		diff_tail(new_row, previous_row, row, index, last, open_start, spans);
+	}
+#endif
+}
+
+frame_differ::frame_differ() : frame_differ(get_best_isa())
+{
+}
+
+frame_differ::frame_differ(const diff_isa isa) : isa(is_supported(isa) ? isa : get_best_isa()), function(diff_row_scalar)
+{
+#ifdef FRAME_DIFFER_X86
+	if (this->isa == diff_avx2)
+		this->function = diff_row_avx2;
+	else if (this->isa == diff_sse2)
+		this->function = diff_row_sse2;
+#endif
+}
+
+void frame_differ::diff_row(const uint32_t* new_row, const uint32_t* previous_row, const int16_t row, const int16_t first, const int16_t last, std::vector<cell_span>& spans)
+{
+	this->function(new_row, previous_row, row, first, last, spans);
+}
+
+diff_isa frame_differ::get_isa()
+{
+	return this->isa;
+}
+
+bool frame_differ::is_supported(const diff_isa isa)
+{
+	switch (isa)
+	{
+	case diff_scalar:
+		return true;
+
+#ifdef FRAME_DIFFER_X86
+	case diff_sse2:
+	{
+#if defined(_M_X64) || defined(__x86_64__)
+		return true;
+#elif defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 1);
+		return (info[3] & (1 << 26)) != 0;
+#else
+		return __builtin_cpu_supports("sse2");
+#endif
+	}
+
+	case diff_avx2:
+	{
+#ifdef _MSC_VER
+		// THE CPU HAS TO SUPPORT IT AND THE OPERATING SYSTEM HAS TO SAVE THE YMM REGISTERS
+		int info[4];
+		__cpuid(info, 1);
+		if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 0x6) != 0x6)
+			return false;
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+#endif
+
+	default:
+		return false;
+	}
+}
+
+diff_isa frame_differ::get_best_isa()
+{
+	static const auto best = []() {
+		auto isa = static_cast<diff_isa>(diff_isa_count - 1);
+		while (!is_supported(isa))
+			isa = static_cast<diff_isa>(isa - 1);
+
+		return isa;
+	}();
+
+	return best;
+}
+
+const char* frame_differ::get_isa_name(const diff_isa isa)
+{
+	static constexpr const char* names[diff_isa_count] = { "scalar", "sse2", "avx2" };
+	return isa < diff_isa_count ? names[isa] : "unknown";
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// CELLS [first, last) OF ROW row CHANGED SINCE THE LAST FRAME
+struct cell_span
+{
+	int16_t row;
+	int16_t first;
+	int16_t last;
+};
+
+// INSTRUCTION SETS frame_differ CAN COMPARE ROWS WITH, NARROWEST FIRST
+enum diff_isa : uint8_t
+{
+	// ONE CELL AT A TIME, ANY CPU
+	diff_scalar,
+
+	// 8 CELLS AT A TIME, EVERY x86-64 CPU
+	diff_sse2,
+
+	// 16 CELLS AT A TIME
+	diff_avx2,
+
+	diff_isa_count
+};
+
+// COMPARES ROWS OF PACKED 32-BIT CELLS AND COLLECTS THE RUNS THAT DIFFER
+// BLOCKS WHERE NOTHING CHANGED, MOST OF A FRAME, COST ONE COMPARE AND ONE BRANCH PER 8 OR 16 CELLS
+// THE INSTRUCTION SET IS PICKED ONCE AT RUNTIME, THE BINARY ITSELF ONLY NEEDS SSE2 ON x86
+class frame_differ
+{
+public:
+	// THE WIDEST INSTRUCTION SET THIS CPU SUPPORTS
+	frame_differ();
+
+	// FALLS BACK TO THE WIDEST SUPPORTED ONE IF isa ISN'T
+	frame_differ(const diff_isa isa);
+
+	// APPEND A SPAN FOR EVERY RUN OF CELLS IN [first, last) WHERE new_row AND previous_row DIFFER
+	void diff_row(const uint32_t* new_row, const uint32_t* previous_row, const int16_t row, const int16_t first, const int16_t last, std::vector<cell_span>& spans);
+
+	diff_isa get_isa();
+
+	static bool is_supported(const diff_isa isa);
+	static diff_isa get_best_isa();
+	static const char* get_isa_name(const diff_isa isa);
+
+private:
+	using row_function = void(*)(const uint32_t*, const uint32_t*, const int16_t, const int16_t, const int16_t, std::vector<cell_span>&);
+
+	diff_isa isa;
+	row_function function;
+};
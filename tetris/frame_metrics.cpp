@@ -0,0 +1,115 @@
+#include "frame_metrics.hpp"
+#include <csignal>
+#include <fstream>
+
+namespace
+{
+	volatile std::sig_atomic_t dump_requested = 0;
+
+	void request_dump(int)
+	{
+		dump_requested = 1;
+	}
+
+	bool ends_with(const std::string& text, const std::string& suffix)
+	{
+		return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+	}
+}
+
+latency_histogram& frame_metrics::get_histogram(const frame_phase phase)
+{
+	return this->histograms[phase];
+}
+
+void frame_metrics::merge(const frame_metrics& other)
+{
+	for (uint8_t phase = 0; phase < phase_count; phase++)
+		this->histograms[phase].merge(other.histograms[phase]);
+}
+
+void frame_metrics::write_csv(std::ostream& output)
+{
+	output << "phase,count,mean_ns,p50_ns,p95_ns,p99_ns,max_ns\n";
+
+	for (uint8_t phase = 0; phase < phase_count; phase++)
+	{
+		auto& histogram = this->histograms[phase];
+		const auto mean = histogram.get_count() != 0 ? histogram.get_total() / histogram.get_count() : 0;
+
+		output << get_phase_name(static_cast<frame_phase>(phase)) << ','
+			<< histogram.get_count() << ',' << mean << ','
+			<< histogram.get_percentile(50.0) << ',' << histogram.get_percentile(95.0) << ','
+			<< histogram.get_percentile(99.0) << ',' << histogram.get_max() << '\n';
+	}
+}
+
+void frame_metrics::write_json(std::ostream& output)
+{
+	output << "{\n\t\"phases\": [\n";
+
+	for (uint8_t phase = 0; phase < phase_count; phase++)
+	{
+		auto& histogram = this->histograms[phase];
+		const auto mean = histogram.get_count() != 0 ? histogram.get_total() / histogram.get_count() : 0;
+
+		output << "\t\t{ \"phase\": \"" << get_phase_name(static_cast<frame_phase>(phase))
+			<< "\", \"count\": " << histogram.get_count() << ", \"mean_ns\": " << mean
+			<< ", \"p50_ns\": " << histogram.get_percentile(50.0) << ", \"p95_ns\": " << histogram.get_percentile(95.0)
+			<< ", \"p99_ns\": " << histogram.get_percentile(99.0) << ", \"max_ns\": " << histogram.get_max()
+			<< (phase + 1 < phase_count ? " },\n" : " }\n");
+	}
+
+	output << "\t]\n}\n";
+}
+
+bool frame_metrics::write(const std::string& path)
+{
+	std::ofstream file(path, std::ios::trunc);
+	if (!file)
+		return false;
+
+	if (ends_with(path, ".json"))
+		this->write_json(file);
+	else
+		this->write_csv(file);
+
+	return static_cast<bool>(file);
+}
+
+const char* frame_metrics::get_phase_name(const frame_phase phase)
+{
+	static constexpr std::array<const char*, phase_count> names =
+	{
+		"input",
+		"step",
+		"draw_solid",
+		"ghost",
+		"draw_piece",
+		"draw_hud",
+		"update_scene",
+		"sleep_overshoot",
+		"frame",
+		"input_latency"
+	};
+
+	return names[phase];
+}
+
+void frame_metrics::install_dump_signal()
+{
+#if defined(SIGBREAK)
+	std::signal(SIGBREAK, request_dump);
+#elif defined(SIGUSR1)
+	std::signal(SIGUSR1, request_dump);
+#endif
+}
+
+bool frame_metrics::take_dump_request()
+{
+	if (dump_requested == 0)
+		return false;
+
+	dump_requested = 0;
+	return true;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include "latency_histogram.hpp"
+
+// PARTS OF ONE FRAME OF tetris::game_loop, IN THE ORDER THEY RUN
+enum frame_phase : uint8_t
+{
+	phase_input,
+	phase_step,
+	phase_draw_solid,
+	phase_ghost,
+	phase_draw_piece,
+	phase_draw_hud,
+	phase_update_scene,
+	phase_sleep_overshoot,
+	phase_frame,
+
+	// NOT A PART OF THE FRAME: FROM A KEY EVENT TO THE END OF THE TICK THAT APPLIED IT
+	phase_input_latency,
+	phase_count
+};
+
+// TIME SPENT IN EVERY PHASE OF EVERY FRAME, ONE HISTOGRAM PER PHASE
+// ONLY COMPILED IN WITH TETRIS_FRAME_METRICS, OTHERWISE now AND lap ARE EMPTY AND
+// THE COMPILER REMOVES THE CALLS, THE CLOCK IS NEVER READ
+class frame_metrics
+{
+public:
+	using clock = std::chrono::steady_clock;
+
+#ifdef TETRIS_FRAME_METRICS
+	static constexpr bool enabled = true;
+#else
+	static constexpr bool enabled = false;
+#endif
+
+	inline clock::time_point now()
+	{
+		if constexpr (enabled)
+			return clock::now();
+		else
+			return clock::time_point();
+	}
+
+	// RECORD THE TIME SINCE start AS phase, RETURNS THE END SO THE NEXT PHASE STARTS THERE
+	inline clock::time_point lap(const frame_phase phase, const clock::time_point start)
+	{
+		if constexpr (enabled)
+		{
+			const auto end = clock::now();
+			this->record(phase, end - start);
+			return end;
+		}
+		else
+			return start;
+	}
+
+	inline void record(const frame_phase phase, const clock::duration duration)
+	{
+		if constexpr (enabled)
+			this->histograms[phase].add(static_cast<uint64_t>(std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count())));
+	}
+
+	latency_histogram& get_histogram(const frame_phase phase);
+
+	// ADD THE SAMPLES OF other, FOR PHASES RECORDED ON ANOTHER THREAD
+	void merge(const frame_metrics& other);
+
+	// ONE ROW OR OBJECT PER PHASE: count, mean, p50, p95, p99 AND max IN NANOSECONDS
+	void write_csv(std::ostream& output);
+	void write_json(std::ostream& output);
+
+	// JSON IF path ENDS WITH .json, CSV OTHERWISE, FALSE IF THE FILE CAN'T BE WRITTEN
+	bool write(const std::string& path);
+
+	static const char* get_phase_name(const frame_phase phase);
+
+	// SIGUSR1, OR CTRL+BREAK ON WINDOWS, ASKS FOR A DUMP WHILE THE GAME RUNS
+	// THE HANDLER ONLY SETS A FLAG, THE GAME LOOP CHECKS IT ONCE PER FRAME
+	static void install_dump_signal();
+	static bool take_dump_request();
+
+private:
+	std::array<latency_histogram, phase_count> histograms;
+};
@@ -0,0 +1,85 @@
+#include "frame_scheduler.hpp"
+#include <algorithm>
+#include <thread>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+frame_scheduler::frame_scheduler(input_reader& input, const scheduler_mode mode) : input(input), mode(mode), statistics(), origin()
+{
+}
+
+void frame_scheduler::start()
+{
+	this->origin = clock::now();
+	this->statistics = scheduler_statistics();
+}
+
+uint64_t frame_scheduler::get_target_tick(const uint64_t current_tick)
+{
+	if (this->mode == scheduler_fixed)
+		return current_tick + 1;
+
+	const auto elapsed_ticks = static_cast<uint64_t>((clock::now() - this->origin) / tick_length);
+	return std::max(current_tick + 1, elapsed_ticks);
+}
+
+bool frame_scheduler::wait(const clock::time_point frame_start, const uint64_t next_event_tick)
+{
+	++this->statistics.wakeups;
+
+	if (this->mode == scheduler_fixed)
+	{
+		// SLEEP UNTIL ~17ms HAS PASSED FOR CONSISTENT 60 FPS
+		std::this_thread::sleep_until(frame_start + std::chrono::milliseconds(1000 / 60));
+		return false;
+	}
+
+	const auto woken_by_input = this->input.wait(this->get_tick_time(next_event_tick));
+	this->statistics.input_wakeups += woken_by_input;
+
+	return woken_by_input;
+}
+
+frame_scheduler::clock::time_point frame_scheduler::get_tick_time(const uint64_t tick)
+{
+	return this->origin + tick_length * tick;
+}
+
+uint64_t frame_scheduler::get_tick_at(const clock::time_point time)
+{
+	if (time <= this->origin)
+		return 0;
+
+	return static_cast<uint64_t>((time - this->origin + tick_length - clock::duration(1)) / tick_length);
+}
+
+scheduler_mode& frame_scheduler::get_mode()
+{
+	return this->mode;
+}
+
+scheduler_statistics& frame_scheduler::get_statistics()
+{
+	return this->statistics;
+}
+
+uint64_t frame_scheduler::get_process_cpu_nanoseconds()
+{
+#ifdef _WIN32
+	FILETIME creation_time, exit_time, kernel_time, user_time;
+	if (!GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time))
+		return 0;
+
+	// 100 NS UNITS
+	const auto to_ticks = [](const FILETIME& time) { return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime; };
+	return (to_ticks(kernel_time) + to_ticks(user_time)) * 100;
+#else
+	rusage usage{};
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+
+	const auto to_nanoseconds = [](const timeval& time) { return static_cast<uint64_t>(time.tv_sec) * 1'000'000'000 + static_cast<uint64_t>(time.tv_usec) * 1'000; };
+	return to_nanoseconds(usage.ru_utime) + to_nanoseconds(usage.ru_stime);
+#endif
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include "input_reader.hpp"
+#include "tetris_engine.hpp"
+
+enum scheduler_mode : uint8_t
+{
+	// ONE TICK AND A FULL REDRAW EVERY 16 MS, WHETHER ANYTHING CHANGED OR NOT
+	scheduler_fixed,
+
+	// SLEEP UNTIL INPUT OR THE NEXT GRAVITY TICK, CATCH UP THE IDLE TICKS AND REDRAW WHAT CHANGED
+	scheduler_event
+};
+
+struct scheduler_statistics
+{
+	uint64_t wakeups = 0;
+	uint64_t input_wakeups = 0;
+	// WRITTEN BY THE RENDER THREAD
+	uint64_t frames_rendered = 0;
+
+	// SNAPSHOTS REPLACED BY A NEWER ONE BEFORE THE RENDER THREAD GOT TO THEM
+	uint64_t frames_dropped = 0;
+};
+
+// DECIDES WHEN tetris::game_loop RUNS AND WHICH ENGINE TICK IT SHOULD BE AT
+// TICKS ARE 1/60 S APART COUNTED FROM start, IN EVENT MODE THE LOOP SKIPS ALL TICKS WHERE
+// NOTHING HAPPENS AND STEPS THEM IN ONE GO WHEN IT WAKES, SO GRAVITY KEEPS THE SAME PACE
+class frame_scheduler
+{
+public:
+	using clock = std::chrono::steady_clock;
+
+	static constexpr clock::duration tick_length = std::chrono::duration_cast<clock::duration>(std::chrono::nanoseconds(1'000'000'000 / tetris_engine::ticks_per_second));
+
+	frame_scheduler(input_reader& input, const scheduler_mode mode = scheduler_event);
+
+	// TICK 0 IS NOW
+	void start();
+
+	// TICK THE ENGINE SHOULD BE AT AFTER THIS FRAME, ALWAYS AT LEAST ONE AHEAD OF current_tick
+	// A BURST OF INPUT FASTER THAN THE TICK RATE CAN PUT THE ENGINE AHEAD OF THE CLOCK,
+	// THE NEXT IDLE WAKEUP WAITS FOR THE CLOCK TO CATCH UP
+	uint64_t get_target_tick(const uint64_t current_tick);
+
+	// SLEEP UNTIL THE NEXT FRAME, TRUE IF INPUT CUT THE SLEEP SHORT
+	// FIXED: UNTIL 16 MS AFTER frame_start. EVENT: UNTIL INPUT OR next_event_tick, WHICHEVER IS FIRST
+	bool wait(const clock::time_point frame_start, const uint64_t next_event_tick);
+
+	clock::time_point get_tick_time(const uint64_t tick);
+
+	// FIRST TICK AT OR AFTER time
+	uint64_t get_tick_at(const clock::time_point time);
+	scheduler_mode& get_mode();
+	scheduler_statistics& get_statistics();
+
+	// USER + SYSTEM CPU TIME OF THE WHOLE PROCESS
+	static uint64_t get_process_cpu_nanoseconds();
+
+private:
+	input_reader& input;
+	scheduler_mode mode;
+	scheduler_statistics statistics;
+	clock::time_point origin;
+};
@@ -0,0 +1,25 @@
+#include "game_snapshot.hpp"
+#include <algorithm>
+
+void game_snapshot::capture(tetris_engine& engine)
+{
+	this->tick = engine.get_tick();
+	this->board_hash = engine.get_board().get_hash();
+	this->score = engine.get_score();
+
+	this->current_piece = engine.get_current_piece();
+	this->ghost_position = engine.get_drop_position();
+	this->next_piece = engine.get_next_piece();
+	this->saved_piece = engine.get_saved_piece();
+
+	auto& source = engine.get_solid_pieces();
+	if (this->solid_pieces.get_row_count() != source.get_row_count() || this->solid_pieces.get_row_size() != source.get_row_size())
+		this->solid_pieces = array2d<solid_piece>(source.get_row_count(), source.get_row_size());
+
+	// ROWS OF THE ENGINE ARE REACHED THROUGH ITS ROW INDEX, HERE THEY ARE STORED IN ORDER
+	for (size_t y = 0; y < source.get_row_count(); y++)
+	{
+		auto row = source.get_row(static_cast<int32_t>(y));
+		std::copy(row.begin(), row.end(), this->solid_pieces.get_row(static_cast<int32_t>(y)).begin());
+	}
+}
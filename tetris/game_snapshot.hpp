@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include "array2d.hpp"
+#include "screen_vector.hpp"
+#include "solid_piece.hpp"
+#include "tetris_engine.hpp"
+#include "tetromino_data.hpp"
+
+// EVERYTHING THE SCREEN SHOWS OF ONE MOMENT OF THE GAME, COPIED OUT OF THE ENGINE
+// THE RENDER THREAD DRAWS FROM THESE AND NEVER TOUCHES THE ENGINE THE SIMULATION IS STEPPING
+struct game_snapshot
+{
+	uint64_t tick = 0;
+	uint64_t board_hash = 0;
+	uint32_t score = 0;
+
+	tetromino_data current_piece;
+	screen_vector ghost_position;
+	tetromino_data next_piece;
+	tetromino_data saved_piece;
+
+	// SOLID PARTS IN SCREEN ROW ORDER, ALLOCATED BY THE FIRST capture ONLY
+	array2d<solid_piece> solid_pieces;
+
+	void capture(tetris_engine& engine);
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "array2d.hpp"
+
+// array2d WHOSE ROWS ARE REACHED THROUGH A TABLE OF ROW INDICES
+// REMOVING ROWS AND MOVING THE ONES ABOVE THEM DOWN ONLY MOVES INDICES,
+// THE ELEMENTS OF A ROW STAY WHERE THEY ARE UNTIL THE ROW IS REUSED
+template <typename T>
+struct indexed_array2d
+{
+	indexed_array2d() = default;
+	indexed_array2d(size_t x, size_t y) : storage(x, y), row_index(x), removed_rows(x)
+	{
+		for (size_t index = 0; index < x; index++)
+			this->row_index[index] = static_cast<uint32_t>(index);
+	}
+
+	auto get_element(size_t x_index, size_t y_index) -> T&
+	{
+		return this->storage.get_element(this->row_index[x_index], y_index);
+	}
+	auto get_row(int32_t x_index) -> array2d_row<T>
+	{
+		return this->storage.get_row(static_cast<int32_t>(this->row_index[x_index]));
+	}
+
+	auto get_row_count() -> size_t
+	{
+		return this->storage.get_row_count();
+	}
+	auto get_row_size() -> size_t
+	{
+		return this->storage.get_row_size();
+	}
+
+	void fill(const T& value)
+	{
+		this->storage.fill(value);
+	}
+	void fill_row(size_t x_index, const T& value)
+	{
+		this->storage.fill_row(this->row_index[x_index], value);
+	}
+
+	// REMOVE ROWS removed (ASCENDING, count OF THEM) AND MOVE EVERY ROW FROM top DOWN TO THE LAST
+	// REMOVED ONE FURTHER DOWN TO CLOSE THE GAPS. THE REMOVED ROWS COME BACK AT top, FILLED WITH value
+	// COSTS ONE INDEX MOVE PER ROW ABOVE THE LOWEST REMOVED ROW AND ONE FILL PER REMOVED ROW
+	void erase_rows(const int32_t* removed, const int32_t count, const int32_t top, const T& value)
+	{
+		if (count == 0)
+			return;
+
+		// THE KEPT ROWS BETWEEN TWO REMOVED ONES MOVE AS ONE BLOCK, LOWEST BLOCK FIRST
+		auto destination = removed[count - 1];
+		for (auto index = count - 1; index >= 0; index--)
+		{
+			this->removed_rows[index] = this->row_index[removed[index]];
+
+			const auto block_top = index > 0 ? removed[index - 1] + 1 : top;
+			const auto block_bottom = removed[index];
+			std::copy_backward(this->row_index.begin() + block_top, this->row_index.begin() + block_bottom, this->row_index.begin() + destination + 1);
+			destination -= block_bottom - block_top;
+		}
+
+		for (auto index = 0; index < count; index++)
+		{
+			this->row_index[top + index] = this->removed_rows[index];
+			this->storage.fill_row(this->removed_rows[index], value);
+		}
+	}
+
+private:
+	array2d<T> storage;
+
+	// LOGICAL ROW x IS ROW row_index[x] OF storage
+	std::vector<uint32_t> row_index;
+
+	// PHYSICAL ROWS BEING REMOVED WHILE erase_rows RUNS, SIZED ONCE SO COPIES DON'T HAVE TO ALLOCATE EITHER
+	std::vector<uint32_t> removed_rows;
+};
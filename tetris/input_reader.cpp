@@ -0,0 +1,184 @@
+#include "input_reader.hpp"
+#include <cstdio>
+#ifndef _WIN32
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+input_reader::input_reader(const console_handle_t input_handle) : queue(), input_handle(input_handle), statistics(), thread(), running(false)
+{
+#ifdef _WIN32
+	this->held_keys.fill(false);
+#else
+	if (pipe(this->stop_pipe) != 0)
+		this->stop_pipe[0] = this->stop_pipe[1] = -1;
+#endif
+}
+
+input_reader::~input_reader()
+{
+	this->stop();
+
+#ifndef _WIN32
+	if (this->stop_pipe[0] != -1)
+	{
+		close(this->stop_pipe[0]);
+		close(this->stop_pipe[1]);
+	}
+#endif
+}
+
+void input_reader::start()
+{
+#ifdef _WIN32
+	const auto has_input = this->get_input_handle() != INVALID_HANDLE_VALUE;
+#else
+	const auto has_input = this->get_input_handle() != -1 && this->stop_pipe[0] != -1;
+#endif
+	if (!has_input || this->running)
+		return;
+
+	this->statistics = input_statistics();
+	this->running = true;
+	this->thread = std::thread(&input_reader::read_loop, this);
+}
+
+void input_reader::stop()
+{
+	if (!this->running)
+		return;
+
+	this->running = false;
+
+#ifndef _WIN32
+	const char wake = 0;
+	const auto woken = write(this->stop_pipe[1], &wake, 1) == 1;
+#endif
+
+	this->thread.join();
+
+#ifndef _WIN32
+	// THE THREAD ONLY POLLS THE PIPE, TAKE THE BYTE OUT AGAIN FOR THE NEXT start
+	char drained;
+	if (woken && read(this->stop_pipe[0], &drained, 1) != 1)
+		std::fprintf(stderr, "input_reader: stop pipe is broken\n");
+#endif
+}
+
+bool input_reader::wait(const std::chrono::steady_clock::time_point deadline)
+{
+	std::unique_lock<std::mutex> lock(this->wake_mutex);
+	return this->wake_condition.wait_until(lock, deadline, [this] { return !this->queue.empty(); });
+}
+
+key_event_queue& input_reader::get_queue()
+{
+	return this->queue;
+}
+
+console_handle_t& input_reader::get_input_handle()
+{
+	return this->input_handle;
+}
+
+input_statistics& input_reader::get_statistics()
+{
+	return this->statistics;
+}
+
+void input_reader::push(const key_event& event)
+{
+	if (this->queue.try_push(event))
+		++this->statistics.events;
+	else
+		++this->statistics.dropped;
+}
+
+#ifdef _WIN32
+void input_reader::read_loop()
+{
+	INPUT_RECORD records[32];
+	while (this->running)
+	{
+		// SHORT TIMEOUT SO stop DOESN'T WAIT FOR A KEY
+		if (WaitForSingleObject(this->get_input_handle(), 10) != WAIT_OBJECT_0)
+			continue;
+
+		DWORD count;
+		if (!ReadConsoleInputW(this->get_input_handle(), records, 32, &count))
+			return;
+
+		const auto time = std::chrono::steady_clock::now();
+		for (DWORD index = 0; index < count; index++)
+		{
+			// THE RENDER THREAD PICKS THE NEW SIZE UP ON ITS NEXT FRAME
+			if (records[index].EventType == WINDOW_BUFFER_SIZE_EVENT)
+				console_controller::request_resize();
+
+			if (records[index].EventType != KEY_EVENT)
+				continue;
+
+			const auto& key_record = records[index].Event.KeyEvent;
+			const auto key = static_cast<int32_t>(key_record.wVirtualKeyCode);
+			const auto pressed = key_record.bKeyDown != 0;
+
+			// A HELD KEY SENDS KEY DOWN OVER AND OVER, ONLY THE FIRST ONE IS A PRESS
+			if (key >= 256 || this->held_keys[key] == pressed)
+				continue;
+
+			this->held_keys[key] = pressed;
+			this->push({ key, pressed, time });
+		}
+
+		// EMPTY LOCK SO THE GAME THREAD IS EITHER BEFORE ITS CHECK OR ALREADY WAITING
+		{ std::lock_guard<std::mutex> lock(this->wake_mutex); }
+		this->wake_condition.notify_one();
+	}
+}
+#else
+void input_reader::read_loop()
+{
+	uint8_t bytes[64];
+	while (this->running)
+	{
+		pollfd descriptors[2] = { { this->get_input_handle(), POLLIN, 0 }, { this->stop_pipe[0], POLLIN, 0 } };
+		if (poll(descriptors, 2, -1) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return;
+		}
+
+		if (descriptors[1].revents != 0)
+			return;
+
+		const auto count = ::read(this->get_input_handle(), bytes, sizeof(bytes));
+		const auto time = std::chrono::steady_clock::now();
+		if (count <= 0)
+		{
+			// A RAW TERMINAL CAN RETURN NOTHING, A CLOSED PIPE HANGS UP
+			if ((count < 0 && errno != EINTR && errno != EAGAIN) || (descriptors[0].revents & (POLLHUP | POLLERR | POLLNVAL)) != 0)
+				return;
+			continue;
+		}
+
+		for (ssize_t index = 0; index < count;)
+		{
+			int32_t key;
+			index += console_controller::decode_key(bytes + index, count - index, key);
+
+			// NO KEY UP FROM A TERMINAL, EVERY KEY IS A TAP
+			if (key != 0)
+			{
+				this->push({ key, true, time });
+				this->push({ key, false, time });
+			}
+		}
+
+		// EMPTY LOCK SO THE GAME THREAD IS EITHER BEFORE ITS CHECK OR ALREADY WAITING
+		{ std::lock_guard<std::mutex> lock(this->wake_mutex); }
+		this->wake_condition.notify_one();
+	}
+}
+#endif
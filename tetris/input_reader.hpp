@@ -0,0 +1,80 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "console_controller.hpp"
+#include "spsc_queue.hpp"
+
+// A KEY GOING DOWN OR UP, time IS WHEN THE READER THREAD GOT IT FROM THE OPERATING SYSTEM
+struct key_event
+{
+	int32_t key;
+	bool pressed;
+	std::chrono::steady_clock::time_point time;
+};
+
+using key_event_queue = spsc_queue<key_event, 256>;
+
+struct input_statistics
+{
+	uint64_t events = 0;
+
+	// QUEUE WAS FULL, THE GAME STOPPED CONSUMING FOR A WHILE
+	uint64_t dropped = 0;
+};
+
+// READS KEY EVENTS ON ITS OWN THREAD AS SOON AS THEY ARRIVE AND QUEUES THEM IN ORDER
+// SO A TAP SHORTER THAN A FRAME IS NEVER MISSED AND EVERY EVENT KEEPS ITS OWN TIMESTAMP
+// WINDOWS: ReadConsoleInput, WITH REAL KEY UP EVENTS
+// POSIX: THE RAW TERMINAL ONLY SENDS KEY DOWN, EVERY KEY (AND EVERY TERMINAL AUTO REPEAT) IS QUEUED
+// AS A PRESS AND A RELEASE WITH THE SAME TIMESTAMP
+class input_reader
+{
+public:
+	input_reader(const console_handle_t input_handle);
+	~input_reader();
+
+	input_reader(const input_reader&) = delete;
+	input_reader& operator=(const input_reader&) = delete;
+
+	// START AND STOP THE THREAD, NOTHING IS READ WITHOUT A VALID INPUT HANDLE
+	void start();
+	void stop();
+
+	// SLEEP UNTIL AN EVENT IS QUEUED OR deadline PASSES, TRUE IF AN EVENT IS WAITING
+	bool wait(const std::chrono::steady_clock::time_point deadline);
+
+	// ONLY THE GAME THREAD MAY CONSUME
+	key_event_queue& get_queue();
+	console_handle_t& get_input_handle();
+
+	// WRITTEN BY THE READER THREAD, ONLY EXACT AFTER stop
+	input_statistics& get_statistics();
+
+private:
+	void read_loop();
+	void push(const key_event& event);
+
+	key_event_queue queue;
+	console_handle_t input_handle;
+	input_statistics statistics;
+
+	std::thread thread;
+	std::atomic<bool> running;
+
+	// ONLY USED TO SLEEP IN wait, THE QUEUE ITSELF NEVER LOCKS
+	std::mutex wake_mutex;
+	std::condition_variable wake_condition;
+
+#ifdef _WIN32
+	// KEYS CURRENTLY DOWN, THE CONSOLE REPEATS KEY DOWN WHILE A KEY IS HELD
+	std::array<bool, 256> held_keys;
+#else
+	// WRITTEN BY stop TO WAKE THE THREAD OUT OF poll
+	int stop_pipe[2];
+#endif
+};
@@ -0,0 +1,125 @@
+#include "key_repeater.hpp"
+#include <algorithm>
+
+namespace
+{
+	// KEY AND THE ENGINE ACTION IT TRIGGERS
+	constexpr std::array<std::pair<int32_t, input_action>, 6> key_bindings = { {
+		{ key_space, input_hard_drop },
+		{ key_left, input_left },
+		{ key_up, input_rotate },
+		{ key_right, input_right },
+		{ key_down, input_down },
+		{ key_c, input_hold }
+	} };
+
+	// ONLY MOVES REPEAT, HOLDING ROTATE OR HARD DROP DOES IT ONCE
+	constexpr uint8_t repeated_actions = input_left | input_right | input_down;
+
+	uint8_t get_action(const int32_t key)
+	{
+		for (auto[vkey, action] : key_bindings)
+		{
+			if (vkey == key)
+				return action;
+		}
+
+		return input_none;
+	}
+
+	uint32_t get_action_bit(const uint8_t action)
+	{
+		uint32_t bit = 0;
+		while ((action >> bit) != 1)
+			++bit;
+
+		return bit;
+	}
+}
+
+key_repeater::key_repeater(const repeat_settings settings) : held_keys{}, settings(settings), press_times{}, press_count(0)
+{
+}
+
+uint8_t key_repeater::get_input(key_event_queue& queue, const clock::time_point tick_time)
+{
+	uint8_t input = input_none;
+	this->get_press_count() = 0;
+
+	// EVERY EVENT UP TO THIS TICK, IN THE ORDER THE KEYS WERE PRESSED
+	key_event* event;
+	while ((event = queue.peek()) != nullptr && event->time <= tick_time)
+	{
+		const auto action = get_action(event->key);
+		if (action != input_none)
+		{
+			auto& key = this->held_keys[get_action_bit(action)];
+			if (event->pressed)
+			{
+				// TWO TAPS IN ONE TICK ARE TWO MOVES, THE SECOND ONE GOES TO THE NEXT TICK
+				if (input & action)
+					break;
+
+				input |= action;
+				if (this->get_press_count() < max_press_times)
+					this->press_times[this->get_press_count()++] = event->time;
+
+				key.held = (action & repeated_actions) != 0;
+				key.next_repeat = event->time + this->get_settings().delay;
+			}
+			else
+			{
+				key.held = false;
+			}
+		}
+
+		queue.pop();
+	}
+
+	// HELD MOVE KEYS WHOSE NEXT REPEAT IS DUE, REPEATS FASTER THAN A TICK ARE DROPPED
+	for (uint32_t bit = 0; bit < this->held_keys.size(); bit++)
+	{
+		auto& key = this->held_keys[bit];
+		if (!key.held || key.next_repeat > tick_time)
+			continue;
+
+		input |= static_cast<uint8_t>(1 << bit);
+		while (key.next_repeat <= tick_time)
+			key.next_repeat += this->get_settings().interval;
+	}
+
+	return input;
+}
+
+key_repeater::clock::time_point key_repeater::get_next_repeat()
+{
+	auto next_repeat = clock::time_point::max();
+	for (auto& key : this->held_keys)
+	{
+		if (key.held)
+			next_repeat = std::min(next_repeat, key.next_repeat);
+	}
+
+	return next_repeat;
+}
+
+const std::array<key_repeater::clock::time_point, key_repeater::max_press_times>& key_repeater::get_press_times()
+{
+	return this->press_times;
+}
+
+uint32_t& key_repeater::get_press_count()
+{
+	return this->press_count;
+}
+
+void key_repeater::reset()
+{
+	this->held_keys.fill(held_key{});
+	this->get_press_count() = 0;
+}
+
+repeat_settings& key_repeater::get_settings()
+{
+	return this->settings;
+}
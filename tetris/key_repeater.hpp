@@ -0,0 +1,60 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include "input_reader.hpp"
+#include "tetris_engine.hpp"
+
+// DELAYED AUTO SHIFT AND AUTO REPEAT RATE OF THE MOVE KEYS
+struct repeat_settings
+{
+	// HOLD A MOVE KEY THIS LONG BEFORE IT STARTS REPEATING
+	std::chrono::steady_clock::duration delay = std::chrono::milliseconds(167);
+
+	// THEN MOVE AGAIN THIS OFTEN, THE ENGINE TAKES AT MOST ONE MOVE PER TICK
+	std::chrono::steady_clock::duration interval = std::chrono::milliseconds(33);
+};
+
+// TURNS TIMESTAMPED KEY EVENTS INTO THE input_action BITMASK OF EACH ENGINE TICK
+// REPEATS ARE TIMED FROM WHEN THE KEY WENT DOWN, NOT COUNTED IN FRAMES, SO THEY KEEP THEIR PACE
+// WHETHER THE LOOP RUNS EVERY TICK OR SLEEPS UNTIL THE NEXT EVENT
+class key_repeater
+{
+public:
+	using clock = std::chrono::steady_clock;
+
+	// AT MOST THIS MANY PRESSES ARE TIMED PER TICK
+	static constexpr uint32_t max_press_times = 8;
+
+	key_repeater(const repeat_settings settings = repeat_settings());
+
+	// INPUT OF THE TICK AT tick_time, TAKES EVENTS UP TO tick_time FROM queue IN ORDER
+	// A SECOND PRESS OF AN ACTION THAT IS ALREADY IN THIS TICK STAYS QUEUED FOR THE NEXT ONE
+	uint8_t get_input(key_event_queue& queue, const clock::time_point tick_time);
+
+	// WHEN THE NEXT REPEAT IS DUE, clock::time_point::max() WHILE NO MOVE KEY IS HELD
+	clock::time_point get_next_repeat();
+
+	// WHEN THE KEYS THE LAST get_input TURNED INTO ACTIONS WENT DOWN
+	const std::array<clock::time_point, max_press_times>& get_press_times();
+	uint32_t& get_press_count();
+
+	// RELEASE ALL KEYS
+	void reset();
+
+	repeat_settings& get_settings();
+
+private:
+	struct held_key
+	{
+		bool held;
+		clock::time_point next_repeat;
+	};
+
+	// INDEXED BY THE BIT OF THE input_action
+	std::array<held_key, 8> held_keys;
+	repeat_settings settings;
+
+	std::array<clock::time_point, max_press_times> press_times;
+	uint32_t press_count;
+};
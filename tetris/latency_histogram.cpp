@@ -0,0 +1,88 @@
+#include "latency_histogram.hpp"
+#include <algorithm>
+#include <cmath>
+#include "bit_utils.hpp"
+
+void latency_histogram::add(const uint64_t nanoseconds)
+{
+	++this->buckets[get_bucket(nanoseconds)];
+	++this->count;
+	this->total += nanoseconds;
+	this->max = std::max(this->max, nanoseconds);
+}
+
+void latency_histogram::merge(const latency_histogram& other)
+{
+	for (uint32_t bucket = 0; bucket < bucket_count; bucket++)
+		this->buckets[bucket] += other.buckets[bucket];
+
+	this->count += other.count;
+	this->total += other.total;
+	this->max = std::max(this->max, other.max);
+}
+
+void latency_histogram::reset()
+{
+	*this = latency_histogram();
+}
+
+uint64_t latency_histogram::get_percentile(const double percentile) const
+{
+	if (this->count == 0)
+		return 0;
+
+	// RANK OF THE SAMPLE, 1-BASED, p50 OF 10 SAMPLES IS THE 5TH
+	const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * this->count)));
+
+	uint64_t seen = 0;
+	for (uint32_t bucket = 0; bucket < bucket_count; bucket++)
+	{
+		seen += this->buckets[bucket];
+		if (seen >= rank)
+			return std::min(get_bucket_upper_bound(bucket), this->max);
+	}
+
+	return this->max;
+}
+
+uint64_t latency_histogram::get_count() const
+{
+	return this->count;
+}
+
+uint64_t latency_histogram::get_total() const
+{
+	return this->total;
+}
+
+uint64_t latency_histogram::get_max() const
+{
+	return this->max;
+}
+
+uint32_t latency_histogram::get_bucket(const uint64_t nanoseconds)
+{
+	// VALUES BELOW sub_bucket_count GET A BUCKET EACH
+	if (nanoseconds < sub_bucket_count)
+		return static_cast<uint32_t>(nanoseconds);
+
+	// POWER OF TWO PICKS THE GROUP, THE NEXT sub_bucket_bits BITS PICK THE BUCKET INSIDE IT
+	const auto highest_bit = bit_utils::highest_bit(nanoseconds);
+	const auto group = static_cast<uint32_t>(highest_bit) - sub_bucket_bits + 1;
+	const auto sub_bucket = static_cast<uint32_t>(nanoseconds >> (highest_bit - sub_bucket_bits)) & (sub_bucket_count - 1);
+
+	return std::min(group * sub_bucket_count + sub_bucket, bucket_count - 1);
+}
+
+uint64_t latency_histogram::get_bucket_upper_bound(const uint32_t bucket)
+{
+	if (bucket < sub_bucket_count)
+		return bucket;
+
+	const auto group = bucket / sub_bucket_count;
+	const auto sub_bucket = bucket % sub_bucket_count;
+	const auto shift = group - 1;
+
+	// LOWEST VALUE OF THE NEXT BUCKET, MINUS ONE
+	return ((static_cast<uint64_t>(sub_bucket_count + sub_bucket + 1)) << shift) - 1;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+// FIXED-BUCKET HISTOGRAM OF DURATIONS IN NANOSECONDS, NOTHING IS ALLOCATED
+// EVERY POWER OF TWO IS SPLIT INTO 8 LINEAR BUCKETS, SO A PERCENTILE IS OFF BY AT MOST 12.5%
+// FROM 1 NS UP TO ABOUT 68 SECONDS, LONGER DURATIONS LAND IN THE LAST BUCKET
+struct latency_histogram
+{
+	static constexpr uint32_t sub_bucket_bits = 3;
+	static constexpr uint32_t sub_bucket_count = 1 << sub_bucket_bits;
+	static constexpr uint32_t bucket_count = (37 - sub_bucket_bits) * sub_bucket_count;
+
+	void add(const uint64_t nanoseconds);
+	void merge(const latency_histogram& other);
+	void reset();
+
+	// UPPER BOUND OF THE BUCKET HOLDING THE GIVEN PERCENTILE, 0 TO 100, NEVER ABOVE get_max
+	uint64_t get_percentile(const double percentile) const;
+
+	uint64_t get_count() const;
+	uint64_t get_total() const;
+	uint64_t get_max() const;
+
+	static uint32_t get_bucket(const uint64_t nanoseconds);
+	static uint64_t get_bucket_upper_bound(const uint32_t bucket);
+
+private:
+	std::array<uint64_t, bucket_count> buckets{};
+	uint64_t count = 0;
+	uint64_t total = 0;
+	uint64_t max = 0;
+};
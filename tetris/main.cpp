@@ -1,9 +1,75 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 #include "tetris.hpp"
+#include "benchmark.hpp"
+#include "replay_reader.hpp"
+#include "replay_writer.hpp"
+
+// REPLAY A RECORDED GAME AT FULL SPEED, OPTIONALLY STARTING FROM A TICK
+int play_replay(const char* path, const char* start_tick)
+{
+	auto reader = replay_reader(path);
+	if (!reader.is_valid())
+	{
+		std::fprintf(stderr, "%s is not a replay\n", path);
+		return 1;
+	}
+
+	const auto start_time = std::chrono::steady_clock::now();
+
+	auto engine = reader.create_engine();
+	if (start_tick != nullptr && !reader.seek(engine, std::strtoull(start_tick, nullptr, 10)))
+	{
+		std::fprintf(stderr, "replay ends before tick %s\n", start_tick);
+		return 1;
+	}
+
+	const auto seek_time = std::chrono::steady_clock::now();
+	const auto first_tick = reader.get_tick();
+
+	uint8_t input = input_none;
+	while (reader.next(input))
+		engine.step(input);
+
+	const auto end_time = std::chrono::steady_clock::now();
+	const auto ticks = reader.get_tick() - first_tick;
+	const auto seek_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(seek_time - start_time).count();
+	const auto play_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - seek_time).count();
+
+	std::printf("seed %llu, %zu keyframes, seek to tick %llu took %.3f ms\n",
+		static_cast<unsigned long long>(engine.get_seed()), reader.get_keyframes().size(),
+		static_cast<unsigned long long>(first_tick), seek_ns / 1e6);
+	std::printf("%llu ticks replayed in %.3f ms (%.2f ns/tick), score %u, %s\n",
+		static_cast<unsigned long long>(ticks), play_ns / 1e6, ticks != 0 ? static_cast<double>(play_ns) / ticks : 0.0,
+		engine.get_score(), engine.is_game_over() ? "game over" : "game not over");
+
+	return 0;
+}
 
 // ENTRYPOINT
-int main()
+int main(int argc, char* argv[])
 {
+	// RUN BENCHMARKS INSTEAD OF THE GAME
+	if (argc > 1 && std::strcmp(argv[1], "--benchmark") == 0)
+	{
+		benchmark::run_all();
+		return 0;
+	}
+
+	// tetris --replay FILE [TICK]
+	if (argc > 2 && std::strcmp(argv[1], "--replay") == 0)
+		return play_replay(argv[2], argc > 3 ? argv[3] : nullptr);
+
+#ifdef _WIN32
 	auto my_console = console_controller(GetStdHandle(STD_OUTPUT_HANDLE), 400, 400);
+#else
+	auto my_console = console_controller(STDOUT_FILENO, 400, 400);
+#endif
 
 	auto tetris_game = tetris(
 		my_console, // CONSOLE HANDLE
@@ -11,5 +77,30 @@ int main()
 		20,			// HEIGHT
 		'#');		// CHARACTER USED TO DRAW BORDER AND PIECES
 
+	// tetris [--record FILE] [--metrics FILE.csv|FILE.json] [--scheduler fixed|event]
+	const char* record_path = nullptr;
+	const char* metrics_path = nullptr;
+	for (auto index = 1; index + 1 < argc; index += 2)
+	{
+		if (std::strcmp(argv[index], "--record") == 0)
+			record_path = argv[index + 1];
+		else if (std::strcmp(argv[index], "--metrics") == 0)
+			metrics_path = argv[index + 1];
+		else if (std::strcmp(argv[index], "--scheduler") == 0)
+			tetris_game.get_scheduler().get_mode() = std::strcmp(argv[index + 1], "fixed") == 0 ? scheduler_fixed : scheduler_event;
+	}
+
+	auto writer = replay_writer(record_path != nullptr ? record_path : "");
+	if (record_path != nullptr)
+		tetris_game.set_replay(&writer);
+
+	if (metrics_path != nullptr)
+	{
+		if (!frame_metrics::enabled)
+			std::fprintf(stderr, "frame metrics are not compiled in, build with TETRIS_FRAME_METRICS\n");
+
+		tetris_game.set_metrics_path(metrics_path);
+	}
+
 	tetris_game.run();
-}
\ No newline at end of file
+}
@@ -0,0 +1,44 @@
+#include "piece_bag.hpp"
+#include <utility>
+
+piece_bag::piece_bag(uint64_t seed) : generator(seed), bag{}, index(tetromino_count)
+{
+}
+
+tetromino_kind piece_bag::next()
+{
+	if (this->index == tetromino_count)
+		this->refill();
+
+	return this->bag[this->index++];
+}
+
+rng::xoshiro256& piece_bag::get_generator()
+{
+	return this->generator;
+}
+
+std::array<tetromino_kind, tetromino_count>& piece_bag::get_bag()
+{
+	return this->bag;
+}
+
+size_t& piece_bag::get_index()
+{
+	return this->index;
+}
+
+void piece_bag::refill()
+{
+	for (size_t kind = 0; kind < tetromino_count; kind++)
+		this->bag[kind] = static_cast<tetromino_kind>(kind);
+
+	// FISHER-YATES
+	for (auto i = static_cast<uint32_t>(tetromino_count) - 1; i > 0; i--)
+	{
+		const auto j = this->generator.get_int(i + 1);
+		std::swap(this->bag[i], this->bag[j]);
+	}
+
+	this->index = 0;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "rng.hpp"
+#include "tetromino.hpp"
+
+// 7-BAG RANDOMIZER: EVERY KIND ONCE PER BAG, IN SHUFFLED ORDER
+// SO THERE ARE AT MOST 12 PIECES BETWEEN TWO OF THE SAME KIND
+struct piece_bag
+{
+	piece_bag(uint64_t seed = 0);
+
+	tetromino_kind next();
+
+	rng::xoshiro256& get_generator();
+	std::array<tetromino_kind, tetromino_count>& get_bag();
+	size_t& get_index();
+
+private:
+	void refill();
+
+	rng::xoshiro256 generator;
+	std::array<tetromino_kind, tetromino_count> bag;
+	size_t index;
+};
@@ -0,0 +1,77 @@
+#include "placement_bot.hpp"
+#include <algorithm>
+#include <limits>
+
+placement_bot::placement_bot(const placement_weights& weights) : weights(weights), target(), has_target(false), placements_evaluated(0)
+{
+}
+
+step_result placement_bot::step(tetris_engine& engine)
+{
+	if (!this->has_target)
+	{
+		this->target = this->find_best_placement(engine);
+		this->has_target = true;
+	}
+
+	const auto result = engine.step(placement_search::steer(engine, this->target));
+
+	// NEXT PIECE NEEDS A NEW PLAN
+	if (result.locked || result.game_over)
+		this->has_target = false;
+
+	return result;
+}
+
+void placement_bot::reset()
+{
+	this->has_target = false;
+}
+
+placement placement_bot::find_best_placement(tetris_engine& engine)
+{
+	if (engine.get_border_width() > board_shape::max_width)
+		return placement_search::drop_in_place(engine);
+
+	return this->find_best_placement(engine, board_shape(engine.get_border_width(), engine.get_border_height()));
+}
+
+placement placement_bot::find_best_placement(tetris_engine& engine, const board_shape& shape)
+{
+	// SNAPSHOT THE INSIDE OF THE BORDER, REUSING THE SAME BUFFERS EVERY PIECE
+	const auto row_count = shape.get_row_count();
+
+	this->board_rows.resize(row_count);
+	this->scratch_rows.resize(row_count);
+	placement_search::copy_rows(engine, this->board_rows.data());
+
+	auto& current = engine.get_current_piece();
+	const int32_t start_x = current.get_position().x();
+	const int32_t start_y = current.get_position().y();
+
+	// NOTHING FITS, JUST DROP WHERE IT IS
+	auto best = placement_search::drop_in_place(engine);
+
+	placement_search::for_each_placement(this->board_rows.data(), shape, current.get_piece(), start_x, start_y,
+		[&](const tetromino& piece, const int32_t rotation_y, const int32_t x, const int32_t y)
+		{
+			++this->placements_evaluated;
+
+			std::copy(this->board_rows.begin(), this->board_rows.end(), this->scratch_rows.begin());
+			auto hash = uint64_t(0);
+			const auto lines = placement_search::place(this->scratch_rows.data(), shape, piece, x, y, hash);
+
+			const auto score = this->weights.lines_cleared * lines +
+				placement_search::evaluate(this->scratch_rows.data(), shape, this->weights);
+
+			if (score > best.score)
+				best = placement{ piece.get_rotation(), rotation_y, x, y, score };
+		});
+
+	return best;
+}
+
+uint64_t& placement_bot::get_placements_evaluated()
+{
+	return this->placements_evaluated;
+}
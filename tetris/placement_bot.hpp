@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "bitboard.hpp"
+#include "board_shape.hpp"
+#include "placement_search.hpp"
+#include "tetris_engine.hpp"
+
+// PLAYS BY TRYING EVERY (ROTATION, COLUMN) HARD DROP OF THE CURRENT PIECE
+// AND STEERING TOWARDS THE BEST ONE WITH THE SAME INPUT A PLAYER WOULD USE
+class placement_bot
+{
+public:
+	placement_bot(const placement_weights& weights = placement_weights());
+
+	// PLAY ONE TICK: PLAN WHEN A NEW PIECE APPEARS, THEN FALL, ROTATE, MOVE AND DROP ONE ACTION PER TICK
+	step_result step(tetris_engine& engine);
+
+	// FORGET THE PLAN FOR THE CURRENT PIECE, FOR REUSING THE BOT IN ANOTHER GAME
+	void reset();
+
+	// BEST PLACEMENT OF THE CURRENT PIECE, SEE placement_search::for_each_placement
+	// BOARDS WIDER THAN board_shape::max_width ARE NOT SEARCHED, THE PIECE DROPS WHERE IT IS
+	placement find_best_placement(tetris_engine& engine);
+
+	// PLACEMENTS SCORED SO FAR
+	uint64_t& get_placements_evaluated();
+
+private:
+	// THE SEARCH ITSELF, ON THE SHAPE OF engine's BOARD
+	placement find_best_placement(tetris_engine& engine, const board_shape& shape);
+
+	placement_weights weights;
+
+	// PLAN FOR THE CURRENT PIECE
+	placement target;
+	bool has_target;
+
+	// INSIDE OF THE ENGINE'S bitboard, AND A COPY TO DROP PIECES INTO
+	std::vector<bitboard::row_t> board_rows;
+	std::vector<bitboard::row_t> scratch_rows;
+
+	uint64_t placements_evaluated;
+};
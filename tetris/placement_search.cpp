@@ -0,0 +1,125 @@
+#include "placement_search.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <limits>
+
+void placement_search::copy_rows(tetris_engine& engine, row_t* rows)
+{
+	for (int32_t y = 1; y < engine.get_border_height(); y++)
+		rows[y - 1] = engine.get_board().get_row(y)[0];
+}
+
+placement placement_search::drop_in_place(tetris_engine& engine)
+{
+	auto& current = engine.get_current_piece();
+	const int32_t y = current.get_position().y();
+	return placement{ current.get_piece().get_rotation(), y, current.get_position().x(), y, -std::numeric_limits<float>::infinity() };
+}
+
+int32_t placement_search::place(row_t* rows, const board_shape& shape, const tetromino& piece, const int32_t x, const int32_t y, uint64_t& hash)
+{
+	auto lowest_full_row = -1;
+	for (auto part : piece.get_elements())
+	{
+		const auto bit = x + part.x() + bitboard::margin;
+		const auto index = y + part.y() - 1;
+
+		rows[index] |= row_t(1) << bit;
+		hash ^= zobrist::cell_key(bit, index + 1);
+
+		if (rows[index] == bitboard::full_row)
+			lowest_full_row = std::max(lowest_full_row, index);
+	}
+
+	if (lowest_full_row < 0)
+		return 0;
+
+	// CLEAR FULL ROWS BY PACKING THE OTHERS TOWARDS THE FLOOR, ONLY ROWS ABOVE THE LOWEST FULL ONE MOVE
+	const auto inside = ~shape.get_empty_row();
+	auto lines_cleared = 0;
+	auto destination = lowest_full_row;
+	for (auto source = lowest_full_row; source >= 0; source--)
+	{
+		const auto row = rows[source];
+		const auto solid = row & inside;
+		const auto key = solid != 0 ? bitboard::row_key(solid, source + 1) : 0;
+		hash ^= zobrist::rotate_left(key, source + 1);
+
+		if (row == bitboard::full_row)
+			++lines_cleared;
+		else
+		{
+			// A ROW MOVING INTO ANOTHER BAND OF 64 LINES TAKES THAT BAND'S KEYS, SEE zobrist.hpp
+			const auto moved_key = solid != 0 && !zobrist::same_band(source + 1, destination + 1) ? bitboard::row_key(solid, destination + 1) : key;
+			hash ^= zobrist::rotate_left(moved_key, destination + 1);
+			rows[destination--] = row;
+		}
+	}
+	for (; destination >= 0; destination--)
+		rows[destination] = shape.get_empty_row();
+
+	return lines_cleared;
+}
+
+uint64_t placement_search::hash_rows(const row_t* rows, const board_shape& shape)
+{
+	uint64_t hash = 0;
+	for (auto index = 0; index < shape.get_row_count(); index++)
+		hash ^= zobrist::rotate_left(bitboard::row_key(rows[index] & ~shape.get_empty_row(), index + 1), index + 1);
+
+	return hash;
+}
+
+float placement_search::evaluate(const row_t* rows, const board_shape& shape, const placement_weights& weights)
+{
+	// WALK DOWN FROM THE TOP, A COLUMN'S HEIGHT IS SET BY ITS FIRST SOLID CELL
+	// AND EVERY EMPTY CELL BELOW A SOLID ONE IS A HOLE
+	const auto inside = ~shape.get_empty_row();
+	const auto row_count = shape.get_row_count();
+	std::array<int32_t, sizeof(row_t) * 8> heights{};
+
+	row_t covered = 0;
+	auto holes = 0;
+	for (auto y_index = 0; y_index < row_count; y_index++)
+	{
+		const auto row = rows[y_index] & inside;
+
+		for (auto first_cells = row & ~covered; first_cells != 0; first_cells &= first_cells - 1)
+			heights[bit_utils::lowest_bit(first_cells)] = row_count - y_index;
+
+		holes += bit_utils::count_bits(~row & covered);
+		covered |= row;
+	}
+
+	auto aggregate_height = 0;
+	auto bumpiness = 0;
+	for (auto column = 1; column < shape.get_width() - 1; column++)
+	{
+		const auto height = heights[column + bitboard::margin];
+		aggregate_height += height;
+
+		if (column > 1)
+			bumpiness += std::abs(height - heights[column - 1 + bitboard::margin]);
+	}
+
+	return weights.aggregate_height * aggregate_height +
+		weights.holes * holes +
+		weights.bumpiness * bumpiness;
+}
+
+uint8_t placement_search::steer(tetris_engine& engine, const placement& target)
+{
+	// IF GRAVITY GETS IN THE WAY THE PIECE LOCKS EARLY AND THE NEXT ONE IS PLANNED AGAIN
+	auto& current = engine.get_current_piece();
+	if (current.get_piece().get_rotation() != target.rotation)
+		return current.get_position().y() < target.rotation_y ? input_down : input_rotate;
+
+	if (current.get_position().x() < target.x)
+		return input_right;
+
+	if (current.get_position().x() > target.x)
+		return input_left;
+
+	return input_hard_drop;
+}
@@ -0,0 +1,129 @@
+#pragma once
+#include <cstdint>
+#include "bitboard.hpp"
+#include "board_shape.hpp"
+#include "tetris_engine.hpp"
+#include "tetromino.hpp"
+
+// WHERE A PIECE ENDS UP AFTER A HARD DROP
+// rotation_y IS HOW FAR THE PIECE HAS TO FALL BEFORE IT HAS ROOM TO ROTATE
+struct placement
+{
+	uint8_t rotation;
+	int32_t rotation_y;
+	int32_t x;
+	int32_t y;
+	float score;
+};
+
+// WEIGHTS OF THE BOARD FEATURES, TUNED BY YIYUAN LEE
+// https://codemyroad.wordpress.com/2013/04/14/tetris-ai-the-near-perfect-player/
+struct placement_weights
+{
+	float aggregate_height = -0.510066f;
+	float lines_cleared = 0.760666f;
+	float holes = -0.35663f;
+	float bumpiness = -0.184483f;
+};
+
+// PLACEMENT ENUMERATION AND BOARD EVALUATION SHARED BY THE BOTS
+// BOARDS ARE THE ROWS INSIDE THE BORDER OF A bitboard, ROW y AT INDEX y - 1,
+// SO SEARCHES CAN KEEP THEM IN THEIR OWN BUFFERS, ONE WORD PER ROW: BOARDS UP TO 56 COLUMNS
+// EVERYTHING THAT DEPENDS ON THE SIZE OF THE BOARD TAKES A board_shape
+namespace placement_search
+{
+	using row_t = bitboard::row_t;
+
+	// SAME AS bitboard::is_occupied FOR EVERY CELL OF piece, ROW 0 AND get_row_count() + 1 ARE THE BORDER
+	inline bool collides(const row_t* rows, const board_shape& shape, const tetromino& piece, const int32_t x, const int32_t y)
+	{
+		for (auto part : piece.get_elements())
+		{
+			const auto cell_y = y + part.y();
+			const auto bit = static_cast<uint32_t>(x + part.x() + bitboard::margin);
+
+			if (cell_y < 1 || cell_y > shape.get_row_count() || bit >= sizeof(row_t) * 8)
+				return true;
+
+			if ((rows[cell_y - 1] >> bit) & 1)
+				return true;
+		}
+
+		return false;
+	}
+
+	// CALL visit(piece, rotation_y, x, y) FOR EVERY HARD DROP OF piece SPAWNED AT (start_x, start_y)
+	// REACHABLE BY FALLING UNTIL IT CAN ROTATE, ROTATING, THEN MOVING SIDEWAYS
+	// PIECES SPAWN AGAINST THE TOP BORDER, SO MOST CAN ONLY ROTATE AFTER FALLING A FEW ROWS
+	template <typename T>
+	inline void for_each_placement(const row_t* rows, const board_shape& shape, const tetromino spawned_piece, const int32_t start_x, const int32_t start_y, T&& visit)
+	{
+		auto piece = spawned_piece;
+		auto rotation_y = start_y;
+
+		for (size_t turns = 0; turns < tetromino_table::rotation_count; turns++)
+		{
+			// EVERY ROTATION ON THE WAY HAS TO FIT, SAME AS PRESSING ROTATE REPEATEDLY
+			if (turns != 0)
+			{
+				piece = piece.rotate();
+
+				auto fits = [&]()
+				{
+					auto rotated = spawned_piece;
+					for (size_t turn = 0; turn < turns; turn++)
+					{
+						rotated = rotated.rotate();
+						if (collides(rows, shape, rotated, start_x, rotation_y))
+							return false;
+					}
+
+					return true;
+				};
+
+				while (!fits() && !collides(rows, shape, spawned_piece, start_x, rotation_y + 1))
+					++rotation_y;
+
+				if (!fits())
+					return;
+			}
+
+			// COLUMNS REACHABLE BY MOVING SIDEWAYS AT THAT HEIGHT
+			auto left = start_x;
+			while (!collides(rows, shape, piece, left - 1, rotation_y))
+				--left;
+
+			auto right = start_x;
+			while (!collides(rows, shape, piece, right + 1, rotation_y))
+				++right;
+
+			for (auto x = left; x <= right; x++)
+			{
+				auto y = rotation_y;
+				while (!collides(rows, shape, piece, x, y + 1))
+					++y;
+
+				visit(piece, rotation_y, x, y);
+			}
+		}
+	}
+
+	// COPY THE INSIDE OF THE BORDER OF engine's bitboard TO rows, WHICH HOLDS get_border_height() - 1 ROWS
+	void copy_rows(tetris_engine& engine, row_t* rows);
+
+	// THE CURRENT PIECE DROPPED WHERE IT IS, WHAT A SEARCH PLAYS WHEN NOTHING FITS OR THE BOARD IS WIDER THAN board_shape::max_width
+	placement drop_in_place(tetris_engine& engine);
+
+	// LOCK piece AT (x, y) AND REMOVE FULL ROWS, RETURNS HOW MANY WERE REMOVED
+	// hash IS UPDATED THE SAME WAY bitboard KEEPS ITS HASH, ONLY ROWS THAT MOVE ARE REHASHED
+	int32_t place(row_t* rows, const board_shape& shape, const tetromino& piece, const int32_t x, const int32_t y, uint64_t& hash);
+
+	// HASH OF rows FROM SCRATCH, EQUAL TO bitboard::get_hash OF THE SAME BOARD
+	uint64_t hash_rows(const row_t* rows, const board_shape& shape);
+
+	// WEIGHTED HEIGHT, HOLES AND BUMPINESS OF A BOARD, HIGHER IS BETTER
+	float evaluate(const row_t* rows, const board_shape& shape, const placement_weights& weights);
+
+	// INPUT THAT BRINGS THE CURRENT PIECE CLOSER TO target: FALL, ROTATE, MOVE, THEN DROP
+	uint8_t steer(tetris_engine& engine, const placement& target);
+}
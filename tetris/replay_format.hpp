@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+
+// REPLAY FILE LAYOUT, ALL FIXED WIDTH FIELDS ARE LITTLE-ENDIAN
+//
+// HEADER
+//   magic "TRPL", u32 version, i32 width, i32 height, u32 gravity ticks, u64 seed
+//
+// RECORDS, UNTIL THE INDEX
+//   varint (idle << 1)       + u8 input    : idle TICKS WITHOUT INPUT, THEN ONE TICK WITH input
+//   varint (idle << 1 | 1)   + varint size : idle TICKS WITHOUT INPUT, THEN A KEYFRAME OF size BYTES
+//                                            (tetris_engine::save_state AFTER ALL TICKS SO FAR)
+//
+// INDEX, WRITTEN ON CLOSE, MISSING IF THE RECORDING WAS CUT SHORT
+//   n * (u64 tick, u64 keyframe record offset), u64 n, u64 index offset, magic "TRPX"
+//
+// IDLE TICKS COST NOTHING BUT THE RECORD THAT FOLLOWS THEM, SO A GAME OF
+// SEVERAL MINUTES WITH A FEW INPUTS PER SECOND IS A FEW KILOBYTES
+namespace replay_format
+{
+	constexpr uint8_t magic[4] = { 'T', 'R', 'P', 'L' };
+	constexpr uint8_t index_magic[4] = { 'T', 'R', 'P', 'X' };
+	// VERSION 2: FULL LINES ARE CLEARED ON THE TICK THAT LOCKS, KEYFRAMES OF VERSION 1 CAN HOLD UNCLEARED LINES
+	// VERSION 3: PIECE POSITIONS IN KEYFRAMES ARE I32, BOARDS CAN BE TALLER THAN 32767 ROWS
+	constexpr uint32_t version = 3;
+
+	constexpr uint64_t header_size = 28;
+	constexpr uint64_t index_entry_size = 16;
+	constexpr uint64_t index_trailer_size = 20;
+
+	// ONE KEYFRAME PER MINUTE OF PLAY AT 60 TICKS PER SECOND
+	constexpr uint32_t default_keyframe_interval = 3600;
+}
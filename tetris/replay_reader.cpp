@@ -0,0 +1,266 @@
+#include "replay_reader.hpp"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <cstring>
+
+replay_reader::replay_reader(const std::string& path) :
+	data(nullptr), size(0), valid(false), width(0), height(0), gravity_ticks(0), seed(0),
+	records_end(nullptr), stream(nullptr, nullptr), tick(0), pending_idle_ticks(0), has_pending_input(false), pending_input(0)
+{
+	this->map_file(path);
+
+	if (!this->read_header())
+		return;
+
+	this->read_index();
+	this->rewind();
+	this->valid = true;
+}
+
+replay_reader::~replay_reader()
+{
+	this->unmap_file();
+}
+
+bool replay_reader::is_valid()
+{
+	return this->valid;
+}
+
+tetris_engine replay_reader::create_engine()
+{
+	auto engine = tetris_engine(this->width, this->height, this->seed, this->gravity_ticks);
+	engine.start();
+	return engine;
+}
+
+bool replay_reader::next(uint8_t& input)
+{
+	while (true)
+	{
+		if (this->pending_idle_ticks != 0)
+		{
+			--this->pending_idle_ticks;
+			++this->tick;
+			input = input_none;
+			return true;
+		}
+
+		if (this->has_pending_input)
+		{
+			this->has_pending_input = false;
+			++this->tick;
+			input = this->pending_input;
+			return true;
+		}
+
+		if (this->stream.at_end())
+			return false;
+
+		// KEYFRAMES ARE ONLY NEEDED FOR SEEKING, PLAYBACK SKIPS THEM
+		const auto value = this->stream.read_varint();
+		if (value & 1)
+			this->stream.skip(this->stream.read_varint());
+		else
+		{
+			this->pending_input = this->stream.read_fixed<uint8_t>();
+			this->has_pending_input = true;
+		}
+
+		// A RECORDING CUT SHORT ENDS AT ITS LAST COMPLETE RECORD
+		if (this->stream.failed)
+			return false;
+
+		this->pending_idle_ticks = value >> 1;
+	}
+}
+
+bool replay_reader::seek(tetris_engine& engine, const uint64_t target_tick)
+{
+	// LAST KEYFRAME AT OR BEFORE THE TARGET
+	const auto keyframe = std::upper_bound(this->keyframes.begin(), this->keyframes.end(), target_tick,
+		[](const uint64_t tick, const std::pair<uint64_t, uint64_t>& entry) { return tick < entry.first; });
+
+	auto restored = false;
+	if (keyframe != this->keyframes.begin())
+	{
+		const auto[keyframe_tick, offset] = *std::prev(keyframe);
+
+		this->stream = byte_stream::reader(this->data + offset, this->records_end);
+		this->stream.read_varint();
+		const auto state_size = this->stream.read_varint();
+		const auto state = this->stream.skip(state_size);
+
+		restored = !this->stream.failed && engine.load_state(state, state_size);
+		if (restored)
+		{
+			this->tick = keyframe_tick;
+			this->pending_idle_ticks = 0;
+			this->has_pending_input = false;
+		}
+	}
+
+	if (!restored)
+	{
+		this->rewind();
+		engine = this->create_engine();
+	}
+
+	// RESIMULATE THE REST
+	uint8_t input = input_none;
+	while (this->tick < target_tick && this->next(input))
+		engine.step(input);
+
+	return this->tick == target_tick;
+}
+
+uint64_t& replay_reader::get_tick()
+{
+	return this->tick;
+}
+
+std::vector<std::pair<uint64_t, uint64_t>>& replay_reader::get_keyframes()
+{
+	return this->keyframes;
+}
+
+void replay_reader::map_file(const std::string& path)
+{
+#ifdef _WIN32
+	this->mapping_handle = nullptr;
+	this->file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (this->file_handle == INVALID_HANDLE_VALUE)
+		return;
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(this->file_handle, &file_size) || file_size.QuadPart == 0)
+		return;
+
+	this->mapping_handle = CreateFileMappingA(this->file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (this->mapping_handle == nullptr)
+		return;
+
+	this->data = static_cast<const uint8_t*>(MapViewOfFile(this->mapping_handle, FILE_MAP_READ, 0, 0, 0));
+	if (this->data != nullptr)
+		this->size = static_cast<size_t>(file_size.QuadPart);
+#else
+	const auto file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		return;
+
+	struct stat file_status;
+	if (fstat(file, &file_status) == 0 && file_status.st_size > 0)
+	{
+		const auto mapping = mmap(nullptr, static_cast<size_t>(file_status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		if (mapping != MAP_FAILED)
+		{
+			this->data = static_cast<const uint8_t*>(mapping);
+			this->size = static_cast<size_t>(file_status.st_size);
+		}
+	}
+
+	// THE MAPPING STAYS VALID AFTER THE DESCRIPTOR IS CLOSED
+	close(file);
+#endif
+}
+
+void replay_reader::unmap_file()
+{
+#ifdef _WIN32
+	if (this->data != nullptr)
+		UnmapViewOfFile(this->data);
+	if (this->mapping_handle != nullptr)
+		CloseHandle(this->mapping_handle);
+	if (this->file_handle != INVALID_HANDLE_VALUE)
+		CloseHandle(this->file_handle);
+#else
+	if (this->data != nullptr)
+		munmap(const_cast<uint8_t*>(this->data), this->size);
+#endif
+}
+
+bool replay_reader::read_header()
+{
+	if (this->size < replay_format::header_size || std::memcmp(this->data, replay_format::magic, sizeof(replay_format::magic)) != 0)
+		return false;
+
+	auto header = byte_stream::reader(this->data + sizeof(replay_format::magic), this->data + this->size);
+	if (header.read_fixed<uint32_t>() != replay_format::version)
+		return false;
+
+	this->width = header.read_fixed<int32_t>();
+	this->height = header.read_fixed<int32_t>();
+	this->gravity_ticks = header.read_fixed<uint32_t>();
+	this->seed = header.read_fixed<uint64_t>();
+
+	return this->width > 2 && this->height > 1 && this->gravity_ticks != 0;
+}
+
+void replay_reader::read_index()
+{
+	this->records_end = this->data + this->size;
+
+	// INDEX TRAILER AT THE END OF THE FILE, LOOKED UP WITHOUT READING ANY RECORD
+	if (this->size >= replay_format::header_size + replay_format::index_trailer_size &&
+		std::memcmp(this->data + this->size - sizeof(replay_format::index_magic), replay_format::index_magic, sizeof(replay_format::index_magic)) == 0)
+	{
+		auto trailer = byte_stream::reader(this->data + this->size - replay_format::index_trailer_size, this->data + this->size);
+		const auto count = trailer.read_fixed<uint64_t>();
+		const auto index_offset = trailer.read_fixed<uint64_t>();
+
+		const auto index_end = this->size - replay_format::index_trailer_size;
+		if (index_offset >= replay_format::header_size && index_offset <= index_end &&
+			count == (index_end - index_offset) / replay_format::index_entry_size)
+		{
+			auto index = byte_stream::reader(this->data + index_offset, this->data + index_end);
+			for (uint64_t i = 0; i < count; i++)
+			{
+				const auto keyframe_tick = index.read_fixed<uint64_t>();
+				const auto offset = index.read_fixed<uint64_t>();
+				if (offset >= replay_format::header_size && offset < index_offset)
+					this->keyframes.emplace_back(keyframe_tick, offset);
+			}
+
+			this->records_end = this->data + index_offset;
+			return;
+		}
+	}
+
+	// NO INDEX, THE RECORDING WAS CUT SHORT, FIND KEYFRAMES BY WALKING THE RECORDS
+	auto records = byte_stream::reader(this->data + replay_format::header_size, this->records_end);
+	uint64_t ticks = 0;
+	while (!records.at_end())
+	{
+		const auto offset = static_cast<uint64_t>(records.cursor - this->data);
+		const auto value = records.read_varint();
+		ticks += value >> 1;
+
+		if (value & 1)
+		{
+			records.skip(records.read_varint());
+			if (!records.failed)
+				this->keyframes.emplace_back(ticks, offset);
+		}
+		else
+		{
+			records.read_fixed<uint8_t>();
+			++ticks;
+		}
+
+		if (records.failed)
+			break;
+	}
+}
+
+void replay_reader::rewind()
+{
+	this->stream = byte_stream::reader(this->data + replay_format::header_size, this->records_end);
+	this->tick = 0;
+	this->pending_idle_ticks = 0;
+	this->has_pending_input = false;
+}
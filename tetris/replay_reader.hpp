@@ -0,0 +1,77 @@
+#pragma once
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "byte_stream.hpp"
+#include "replay_format.hpp"
+#include "tetris_engine.hpp"
+
+// STREAMS THE INPUT OF A RECORDED GAME FROM A MEMORY MAPPED FILE, SEE replay_format.hpp
+// NOTHING IS SLEPT OR RENDERED, A GAME REPLAYS AS FAST AS tetris_engine::step RUNS
+class replay_reader
+{
+public:
+	replay_reader(const std::string& path);
+	~replay_reader();
+
+	// OWNS THE MAPPING, SO IT CAN'T BE COPIED
+	replay_reader(const replay_reader&) = delete;
+	replay_reader& operator=(const replay_reader&) = delete;
+
+	// FALSE IF THE FILE IS MISSING OR NOT A REPLAY
+	bool is_valid();
+
+	// STARTED ENGINE WITH THE RECORDED SIZE, GRAVITY AND SEED
+	tetris_engine create_engine();
+
+	// INPUT OF THE NEXT TICK, FALSE AT THE END OF THE RECORDING
+	bool next(uint8_t& input);
+
+	// PUT engine IN THE STATE AFTER tick TICKS, STARTING FROM THE CLOSEST KEYFRAME BEFORE IT
+	// FALSE IF THE RECORDING ENDS EARLIER
+	bool seek(tetris_engine& engine, const uint64_t tick);
+
+	// TICKS READ SO FAR
+	uint64_t& get_tick();
+
+	std::vector<std::pair<uint64_t, uint64_t>>& get_keyframes();
+
+private:
+	void map_file(const std::string& path);
+	void unmap_file();
+	bool read_header();
+	void read_index();
+	void rewind();
+
+	// MAPPED FILE
+	const uint8_t* data;
+	size_t size;
+#ifdef _WIN32
+	HANDLE file_handle;
+	HANDLE mapping_handle;
+#endif
+
+	// HEADER
+	bool valid;
+	int32_t width;
+	int32_t height;
+	uint32_t gravity_ticks;
+	uint64_t seed;
+
+	// RECORDS BETWEEN THE HEADER AND THE INDEX
+	const uint8_t* records_end;
+	byte_stream::reader stream;
+
+	// TICK AND FILE OFFSET OF EVERY KEYFRAME
+	std::vector<std::pair<uint64_t, uint64_t>> keyframes;
+
+	// POSITION INSIDE THE CURRENT RECORD
+	uint64_t tick;
+	uint64_t pending_idle_ticks;
+	bool has_pending_input;
+	uint8_t pending_input;
+};
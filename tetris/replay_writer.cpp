@@ -0,0 +1,106 @@
+#include "replay_writer.hpp"
+#include "byte_stream.hpp"
+
+replay_writer::replay_writer(const std::string& path, const uint32_t keyframe_interval) :
+	file(path, std::ios::binary | std::ios::trunc), keyframe_interval(keyframe_interval), idle_ticks(0), bytes_flushed(0)
+{
+}
+
+replay_writer::~replay_writer()
+{
+	this->close();
+}
+
+void replay_writer::begin(tetris_engine& engine)
+{
+	if (!this->is_open())
+		return;
+
+	for (auto byte : replay_format::magic)
+		this->buffer.push_back(byte);
+
+	byte_stream::write_fixed<uint32_t>(this->buffer, replay_format::version);
+	byte_stream::write_fixed<int32_t>(this->buffer, engine.get_border_width());
+	byte_stream::write_fixed<int32_t>(this->buffer, engine.get_border_height());
+	byte_stream::write_fixed<uint32_t>(this->buffer, engine.get_gravity_ticks());
+	byte_stream::write_fixed<uint64_t>(this->buffer, engine.get_seed());
+}
+
+void replay_writer::record(tetris_engine& engine, const uint8_t input)
+{
+	if (!this->is_open())
+		return;
+
+	// KEYFRAME OF THE STATE BEFORE THIS TICK, FLUSHED SO A CRASH LOSES AT MOST ONE INTERVAL
+	const auto tick = engine.get_tick();
+	if (tick != 0 && this->keyframe_interval != 0 && tick % this->keyframe_interval == 0)
+	{
+		this->keyframes.emplace_back(tick, this->bytes_flushed + this->buffer.size());
+
+		this->keyframe.clear();
+		engine.save_state(this->keyframe);
+
+		byte_stream::write_varint(this->buffer, (this->idle_ticks << 1) | 1);
+		byte_stream::write_varint(this->buffer, this->keyframe.size());
+		this->buffer.insert(this->buffer.end(), this->keyframe.begin(), this->keyframe.end());
+		this->idle_ticks = 0;
+
+		this->flush();
+	}
+
+	// IDLE TICKS ARE ONLY COUNTED
+	if (input == input_none)
+	{
+		++this->idle_ticks;
+		return;
+	}
+
+	byte_stream::write_varint(this->buffer, this->idle_ticks << 1);
+	byte_stream::write_fixed<uint8_t>(this->buffer, input);
+	this->idle_ticks = 0;
+
+	if (this->buffer.size() >= 64 * 1024)
+		this->flush();
+}
+
+void replay_writer::close()
+{
+	if (!this->is_open())
+		return;
+
+	// TRAILING IDLE TICKS BECOME ONE LAST RECORD WITHOUT INPUT
+	if (this->idle_ticks != 0)
+	{
+		byte_stream::write_varint(this->buffer, (this->idle_ticks - 1) << 1);
+		byte_stream::write_fixed<uint8_t>(this->buffer, input_none);
+		this->idle_ticks = 0;
+	}
+
+	const auto index_offset = this->bytes_flushed + this->buffer.size();
+	for (auto[tick, offset] : this->keyframes)
+	{
+		byte_stream::write_fixed<uint64_t>(this->buffer, tick);
+		byte_stream::write_fixed<uint64_t>(this->buffer, offset);
+	}
+	byte_stream::write_fixed<uint64_t>(this->buffer, this->keyframes.size());
+	byte_stream::write_fixed<uint64_t>(this->buffer, index_offset);
+	for (auto byte : replay_format::index_magic)
+		this->buffer.push_back(byte);
+
+	this->flush();
+	this->file.close();
+}
+
+bool replay_writer::is_open()
+{
+	return this->file.is_open();
+}
+
+void replay_writer::flush()
+{
+	this->file.write(reinterpret_cast<const char*>(this->buffer.data()), static_cast<std::streamsize>(this->buffer.size()));
+	this->file.flush();
+
+	this->bytes_flushed += this->buffer.size();
+	this->buffer.clear();
+}
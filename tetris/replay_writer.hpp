@@ -0,0 +1,44 @@
+#pragma once
+#include <fstream>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "replay_format.hpp"
+#include "tetris_engine.hpp"
+
+// RECORDS THE SEED AND INPUT OF EVERY TICK OF A GAME, SEE replay_format.hpp
+// CALL record WITH THE INPUT OF EACH TICK BEFORE PASSING IT TO tetris_engine::step
+class replay_writer
+{
+public:
+	replay_writer(const std::string& path, const uint32_t keyframe_interval = replay_format::default_keyframe_interval);
+	~replay_writer();
+
+	// OWNS THE FILE, SO IT CAN'T BE COPIED
+	replay_writer(const replay_writer&) = delete;
+	replay_writer& operator=(const replay_writer&) = delete;
+
+	// WRITE HEADER OF A STARTED GAME
+	void begin(tetris_engine& engine);
+	void record(tetris_engine& engine, const uint8_t input);
+
+	// WRITE PENDING TICKS AND THE KEYFRAME INDEX, ALSO DONE ON DESTRUCTION
+	void close();
+
+	bool is_open();
+
+private:
+	void flush();
+
+	std::ofstream file;
+	std::vector<uint8_t> buffer;
+	std::vector<uint8_t> keyframe;
+
+	// TICK AND FILE OFFSET OF EVERY KEYFRAME
+	std::vector<std::pair<uint64_t, uint64_t>> keyframes;
+
+	uint32_t keyframe_interval;
+	uint64_t idle_ticks;
+	uint64_t bytes_flushed;
+};
@@ -1,24 +1,103 @@
 #pragma once
+#include <array>
 #include <random>
 #include <cstdint>
 
-// rand() IS NOT SECURE
-// THIS IS THE PROPER C++ WAY
-// TO GENERATE RANDOM NUMBERS
+// rand() IS NOT SECURE, std::mt19937 IS 5 KB OF STATE
+// GAMES OWN A SMALL, SEEDABLE GENERATOR SO THE SAME SEED
+// REPRODUCES THE SAME GAME ON ANY THREAD
 namespace rng
 {
-	// GET RNG ENGINE
-	inline std::mt19937& get_generator()
+	// NON-DETERMINISTIC SEED FOR A NEW GAME
+	inline uint64_t get_random_seed()
 	{
-		thread_local std::mt19937 generator(std::random_device{}());
-		return generator;
+		std::random_device device;
+		return (static_cast<uint64_t>(device()) << 32) | device();
 	}
 
-	// GENERATE RANDOM INTEGER OF TYPE T
-	template <typename T>
-	inline T get_int(T min, T max)
+	// SPREADS A SEED OVER THE WHOLE STATE, https://prng.di.unimi.it/splitmix64.c
+	inline uint64_t splitmix64(uint64_t& state)
 	{
-		std::uniform_int_distribution<T> distribution(min, max);
-		return distribution(get_generator());
+		auto result = (state += 0x9E3779B97F4A7C15);
+		result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9;
+		result = (result ^ (result >> 27)) * 0x94D049BB133111EB;
+		return result ^ (result >> 31);
 	}
+
+	// xoshiro256** 1.0, https://prng.di.unimi.it/xoshiro256starstar.c
+	// 32 BYTES OF STATE, SATISFIES UniformRandomBitGenerator
+	struct xoshiro256
+	{
+		using result_type = uint64_t;
+
+		xoshiro256(uint64_t seed = 0)
+		{
+			for (auto& word : this->state)
+				word = splitmix64(seed);
+		}
+
+		static constexpr result_type min()
+		{
+			return 0;
+		}
+		static constexpr result_type max()
+		{
+			return ~result_type(0);
+		}
+
+		inline result_type operator()()
+		{
+			const auto result = rotate_left(this->state[1] * 5, 7) * 9;
+			const auto shifted = this->state[1] << 17;
+
+			this->state[2] ^= this->state[0];
+			this->state[3] ^= this->state[1];
+			this->state[1] ^= this->state[2];
+			this->state[0] ^= this->state[3];
+			this->state[2] ^= shifted;
+			this->state[3] = rotate_left(this->state[3], 45);
+
+			return result;
+		}
+
+		// UNIFORM INTEGER IN [0, bound), MULTIPLY AND SHIFT INSTEAD OF DIVISION
+		// https://arxiv.org/abs/1805.10941
+		inline uint32_t get_int(const uint32_t bound)
+		{
+			auto product = (this->operator()() >> 32) * bound;
+			auto low = static_cast<uint32_t>(product);
+
+			if (low < bound)
+			{
+				const auto threshold = static_cast<uint32_t>(-bound) % bound;
+				while (low < threshold)
+				{
+					product = (this->operator()() >> 32) * bound;
+					low = static_cast<uint32_t>(product);
+				}
+			}
+
+			return static_cast<uint32_t>(product >> 32);
+		}
+
+		// RAW STATE, FOR SAVING AND RESTORING A GAME
+		inline std::array<uint64_t, 4>& get_state()
+		{
+			return this->state;
+		}
+
+		// INDEPENDENT GENERATOR FOR ANOTHER GAME OR THREAD, DERIVED FROM THIS ONE
+		inline xoshiro256 split()
+		{
+			return xoshiro256(this->operator()());
+		}
+
+	private:
+		static inline uint64_t rotate_left(const uint64_t value, const int shift)
+		{
+			return (value << shift) | (value >> (64 - shift));
+		}
+
+		std::array<uint64_t, 4> state;
+	};
 }
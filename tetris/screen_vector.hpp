@@ -4,17 +4,24 @@
 struct screen_vector
 {
 	screen_vector() = default;
-	screen_vector(const int16_t new_x, const int16_t new_y) : data_x(new_x), data_y(new_y) {}
+	constexpr screen_vector(const int32_t new_x, const int32_t new_y) : data_x(new_x), data_y(new_y) {}
 
 	bool operator ==(screen_vector other)
 	{
 		return other.x() == this->x() && other.y() == this->y();
 	}
 
-	int16_t& x();
-	int16_t& y();
+	// READ FOR EVERY CELL OF EVERY COLLISION TEST, KEPT HERE SO THEY INLINE
+	int32_t& x()
+	{
+		return this->data_x;
+	}
+	int32_t& y()
+	{
+		return this->data_y;
+	}
 
 private:
-	int16_t data_x;
-	int16_t data_y;
+	int32_t data_x = 0;
+	int32_t data_y = 0;
 };
\ No newline at end of file
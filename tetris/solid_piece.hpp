@@ -5,8 +5,15 @@ struct solid_piece
 {
 	solid_piece() = default;
 
-	bool& is_valid();
-	uint16_t& get_color();
+	// READ FOR EVERY CELL OF EVERY FRAME, SO THEY LIVE HERE WHERE THEY CAN BE INLINED
+	bool& is_valid()
+	{
+		return this->valid;
+	}
+	uint16_t& get_color()
+	{
+		return this->color_code;
+	}
 
 private:
 	bool valid;
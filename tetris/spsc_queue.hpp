@@ -0,0 +1,66 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// FIXED-SIZE RING BUFFER FOR EXACTLY ONE PRODUCER THREAD AND ONE CONSUMER THREAD, NO LOCKS
+// EACH SIDE ONLY WRITES ITS OWN INDEX, THE RELEASE STORE OF IT PUBLISHES THE SLOT TO THE OTHER SIDE
+// THE INDICES LIVE ON SEPARATE CACHE LINES SO THE TWO THREADS DON'T FIGHT OVER ONE LINE
+template <typename T, size_t capacity>
+class spsc_queue
+{
+	static_assert(capacity != 0 && (capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+	// PRODUCER: FALSE IF THE QUEUE IS FULL
+	bool try_push(const T& value)
+	{
+		const auto tail = this->tail.load(std::memory_order_relaxed);
+		if (tail - this->head.load(std::memory_order_acquire) == capacity)
+			return false;
+
+		this->slots[tail & (capacity - 1)] = value;
+		this->tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// CONSUMER: OLDEST ELEMENT WITHOUT REMOVING IT, nullptr IF EMPTY
+	// STAYS VALID UNTIL pop
+	T* peek()
+	{
+		const auto head = this->head.load(std::memory_order_relaxed);
+		if (head == this->tail.load(std::memory_order_acquire))
+			return nullptr;
+
+		return &this->slots[head & (capacity - 1)];
+	}
+
+	// CONSUMER: REMOVE THE ELEMENT RETURNED BY peek
+	void pop()
+	{
+		this->head.store(this->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	// CONSUMER: FALSE IF EMPTY
+	bool try_pop(T& value)
+	{
+		const auto element = this->peek();
+		if (element == nullptr)
+			return false;
+
+		value = *element;
+		this->pop();
+		return true;
+	}
+
+	// EITHER SIDE, ONLY A HINT WHILE THE OTHER SIDE IS RUNNING
+	bool empty() const
+	{
+		return this->head.load(std::memory_order_acquire) == this->tail.load(std::memory_order_acquire);
+	}
+
+private:
+	alignas(64) std::atomic<size_t> head{ 0 };
+	alignas(64) std::atomic<size_t> tail{ 0 };
+	alignas(64) std::array<T, capacity> slots{};
+};
@@ -1,85 +1,193 @@
 #pragma once
+#include <array>
+#include <atomic>
+#include <charconv>
 #include <chrono>
-#include <map>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
 #include <thread>
 #include <cstdint>
+#include <string>
+#include <vector>
 #include "console_controller.hpp"
+#include "frame_metrics.hpp"
+#include "frame_scheduler.hpp"
+#include "game_snapshot.hpp"
+#include "input_reader.hpp"
+#include "key_repeater.hpp"
+#include "latency_histogram.hpp"
 #include "screen_vector.hpp"
 #include "tetromino.hpp"
 #include "tetromino_data.hpp"
-#include "solid_piece.hpp"
-#include "rng.hpp"
-
-using key_handler_map_t = std::map<int32_t, void(*)(class tetris*, tetromino_data&, screen_vector, bool&)>;
+#include "replay_writer.hpp"
+#include "tetris_engine.hpp"
+#include "triple_buffer.hpp"
 
+// CONSOLE FRONT END, READS KEYS ON A THREAD OF THEIR OWN, STEPS THE ENGINE AT 60 TICKS PER SECOND
+// AND HANDS SNAPSHOTS OF IT TO A RENDER THREAD THAT DRAWS THEM
 class tetris
 {
 public:
-	tetris(console_controller con, int32_t width, int32_t height, int16_t tetris_character) : console(con), border_width(width), border_height(height), piece_character(tetris_character), solid_pieces(height + 1, width + 1)
+	tetris(console_controller& con, int32_t width, int32_t height, int16_t tetris_character) : console(con), engine(width, height), piece_character(tetris_character), replay(nullptr), metrics(), render_metrics(), render_metrics_copy(), render_metrics_requested(false), render_metrics_copied(false), render_metrics_pending(false), metrics_path(), input(con.get_input_handle()), repeater(), input_latency(), scheduler(input), tick_limit(0), drawn(), snapshots(), renderer(), rendering(false), cell_palette{}, board_cells()
 	{
+		// EMPTY, THEN ONE PIECE CELL PER CONSOLE COLOR
+		for (uint16_t color_code = 0; color_code < 16; color_code++)
+			this->cell_palette[color_code + 1] = coordinate_data(tetris_character, color_code);
+
+		// INSIDE OF THE BORDER
+		this->board_cells.resize(static_cast<size_t>(width - 2) * (height - 1));
 	}
 
 	void run();
 
+	// DRAW THE BOARD AND PLAY UNTIL GAME OVER OR THE TICK LIMIT, WITHOUT THE EXIT SCREEN
+	void play();
+
+	// STOP AFTER THIS MANY TICKS EVEN IF THE GAME ISN'T OVER, 0 MEANS NO LIMIT
+	void set_tick_limit(const uint64_t ticks);
+
+	// WHEN THE LOOP RUNS, SEE frame_scheduler
+	frame_scheduler& get_scheduler();
+
+	// KEY EVENTS, READ FROM THE CONSOLE UNLESS ANOTHER HANDLE IS SET BEFORE play
+	input_reader& get_input();
+	key_repeater& get_repeater();
+
+	// FROM A KEY GOING DOWN TO THE END OF THE TICK THAT APPLIED IT, OVER THE LAST GAME
+	latency_histogram& get_input_latency();
+
+	// RECORD EVERY TICK OF THE NEXT GAME, writer MUST OUTLIVE run
+	void set_replay(replay_writer* writer);
+
+	// WRITE FRAME TIMINGS TO path WHEN THE GAME ENDS OR A DUMP SIGNAL ARRIVES, SEE frame_metrics
+	// DOES NOTHING UNLESS BUILT WITH TETRIS_FRAME_METRICS
+	void set_metrics_path(const std::string& path);
+
 private:
 	void show_exit_screen();
 	void draw_boundary();
-	void clear_game_frame();
 	void draw_tetromino(screen_vector position, tetromino comp, const uint8_t color_code);
 	void draw_tetromino(tetromino_data tetromino);
-	tetromino get_random_tetromino();
-	screen_vector get_start_position();
+
+	// PARTS OF THE SCREEN THAT ARE REDRAWN INDEPENDENTLY
+	enum ui_region : uint8_t
+	{
+		region_board = 1 << 0,
+		region_score = 1 << 1,
+		region_next = 1 << 2,
+		region_hold = 1 << 3,
+		region_all = region_board | region_score | region_next | region_hold,
+
+		// BORDER AND LABELS, ONLY ON THE FIRST FRAME AND WHEN THE TERMINAL CHANGED SIZE
+		region_background = 1 << 4
+	};
+
+	// LAYERS OF THE CONSOLE BUFFER, BOTTOM FIRST. THE BORDER AND LABELS ARE DRAWN ONCE,
+	// THE BOARD AND HUD LAYERS ONLY WHEN THEIR REGION CHANGES
+	enum screen_layer : uint8_t
+	{
+		layer_background,
+		layer_board,
+		layer_hud,
+		layer_count
+	};
+
+	// WHAT THE SCREEN SHOWS, COMPARED WITH THE NEXT SNAPSHOT TO FIND WHAT CHANGED
+	struct drawn_state
+	{
+		bool valid = false;
+		uint64_t board_hash = 0;
+		screen_vector position;
+		tetromino piece;
+		uint32_t score = 0;
+		tetromino next;
+		bool has_saved = false;
+		tetromino saved;
+		std::pair<int16_t, int16_t> viewport;
+	};
 
 	// GAME
 	void game_loop();
-	void draw_saved_piece();
-	void draw_next_tetromino();
-	void draw_score();
-	void draw_ghost_tetromino();
-	void draw_solid_parts();
-	void handle_full_lines();
-	bool handle_moving_tetromino(const bool should_move_piece);
-	void add_solid_parts(tetromino& piece, screen_vector& position);
-	void handle_controls(tetromino_data& data, bool& add_new_piece);
-	void move_piece(tetromino_data& data, bool& add_new_piece);
-
-	// GAME DATA
-	tetromino_data current_piece;
-	tetromino_data next_piece;
-	tetromino_data saved_piece;
-
-	tetromino_data& get_current_piece();
-	tetromino_data& get_next_piece();
-	tetromino_data& get_saved_piece();
-
-	bool has_switched_piece;
-	bool& get_switched_piece();
-
-	// COLLISION
-	bool does_element_collide(tetromino& piece, screen_vector position);
-	bool collides(screen_vector part, screen_vector position);
+	bool step_tick(const uint8_t input);
+	void record_input_latency();
+	void draw_saved_piece(game_snapshot& snapshot);
+	void draw_next_tetromino(game_snapshot& snapshot);
+	void draw_score(game_snapshot& snapshot);
+	void draw_ghost_tetromino(game_snapshot& snapshot);
+	void draw_solid_parts(game_snapshot& snapshot);
+
+	// NEXT AND SAVED PIECE, EACH BLITTED AS ONE panel_width x panel_height BLOCK
+	// PART (px, py) OF THE PIECE IS CELL (4 + px, 1 + py) OF THE BLOCK, PARTS ARE -1 TO 2 FROM THE PIECE ORIGIN
+	static constexpr int16_t panel_width = 10;
+	static constexpr int16_t panel_height = 6;
+	void draw_panel(const int16_t x, const int16_t y, tetromino_data& piece);
 
 	// CONSOLE I/O CONTROLLER
-	console_controller console;
+	console_controller& console;
 	console_controller& get_console();
 
+	// GAME LOGIC
+	tetris_engine engine;
+	tetris_engine& get_engine();
+
 	// GAME SETTINGS
-	int32_t border_width;
-	int32_t border_height;
 	int16_t piece_character;
 
 	int32_t& get_border_width();
 	int32_t& get_border_height();
 	int16_t& get_piece_character();
 
-
-	// SCOREBOARD
-	uint32_t score;
-	uint32_t& get_score();
-
-	// ENTITIES
-	array2d<solid_piece> solid_pieces;
-	array2d<solid_piece>& get_solid_pieces();
-
-	tetromino_data generate_tetromino();
-};
\ No newline at end of file
+	// OPTIONAL RECORDING
+	replay_writer* replay;
+
+	// OPTIONAL FRAME TIMINGS, EVERY THREAD RECORDS ITS OWN PHASES SO EVERY HISTOGRAM HAS ONE WRITER
+	// metrics: GAME THREAD, render_metrics: RENDER THREAD
+	frame_metrics metrics;
+	frame_metrics render_metrics;
+
+	// A DUMP WHILE THE GAME RUNS: THE GAME THREAD SETS render_metrics_requested UNDER render_mutex,
+	// THE RENDER THREAD COPIES ITS HISTOGRAMS THERE AND SETS render_metrics_copied
+	// render_metrics_pending (GAME THREAD ONLY) IS SET FROM THE REQUEST UNTIL THE COPY IS WRITTEN, SO THE COPY
+	// ISN'T OVERWRITTEN WHILE IT IS READ
+	frame_metrics render_metrics_copy;
+	bool render_metrics_requested;
+	std::atomic<bool> render_metrics_copied;
+	bool render_metrics_pending;
+
+	std::string metrics_path;
+
+	// metrics AND THE RENDER THREAD'S rendered IN ONE FILE
+	void write_metrics(const frame_metrics& rendered);
+
+	// INPUT
+	input_reader input;
+	key_repeater repeater;
+	latency_histogram input_latency;
+
+	// FRAME TIMING
+	frame_scheduler scheduler;
+	uint64_t tick_limit;
+
+	// RENDERING, ON A THREAD OF ITS OWN SO A SLOW TERMINAL DROPS FRAMES INSTEAD OF DELAYING TICKS
+	// ONLY THE RENDER THREAD TOUCHES THE CONSOLE AND drawn WHILE THE GAME LOOP RUNS
+	drawn_state drawn;
+	triple_buffer<game_snapshot> snapshots;
+	std::thread renderer;
+	std::atomic<bool> rendering;
+	std::mutex render_mutex;
+	std::condition_variable render_condition;
+
+	// CELL OF A SOLID PART, INDEXED BY 0 FOR AN EMPTY ONE OR 1 + ITS COLOR, SO NO CELL NEEDS A BRANCH
+	std::array<coordinate_data, 17> cell_palette;
+
+	// INSIDE OF THE BORDER, FILLED FROM THE SNAPSHOT AND BLITTED IN ONE CALL
+	std::vector<coordinate_data> board_cells;
+
+	void start_renderer();
+	void stop_renderer();
+	void publish_snapshot();
+	void render_loop();
+	uint8_t find_dirty_regions(game_snapshot& snapshot);
+	void render(game_snapshot& snapshot, const uint8_t regions);
+};
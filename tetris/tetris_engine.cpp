@@ -0,0 +1,501 @@
+#include "tetris_engine.hpp"
+#include <algorithm>
+
+tetris_engine::tetris_engine(int32_t width, int32_t height, uint64_t seed, uint32_t gravity_ticks) : has_switched_piece(false), border_width(width), border_height(height), gravity_ticks(gravity_ticks), tick(0), ticks_until_gravity(gravity_ticks), game_over(false), seed(seed), pieces(seed), score(0), solid_pieces(height + 1, width + 1), board(width, height)
+{
+}
+
+void tetris_engine::start()
+{
+	this->get_current_piece() = this->generate_tetromino();
+	this->get_next_piece() = this->generate_tetromino();
+}
+
+step_result tetris_engine::step(const uint8_t input)
+{
+	auto result = step_result{ false, 0, this->is_game_over() };
+	if (result.game_over)
+		return result;
+
+	++this->get_tick();
+
+	// ONLY MOVE CONTROLLABLE TETROMINO EVERY gravity_ticks TICKS
+	const auto should_move_piece = --this->ticks_until_gravity == 0;
+	if (should_move_piece)
+		this->ticks_until_gravity = this->gravity_ticks;
+
+	// HANDLE MOVEMENT, IF NEW PIECE COLLIDES THE GAME IS OVER
+	// FULL LINES CAN ONLY APPEAR WHEN A PIECE LOCKS, THEY ARE CLEARED RIGHT THERE
+	if (!this->handle_moving_tetromino(input, should_move_piece, result.locked, result.lines_cleared))
+		this->is_game_over() = true;
+
+	result.game_over = this->is_game_over();
+	return result;
+}
+
+namespace
+{
+	void save_piece(std::vector<uint8_t>& output, tetromino_data& data)
+	{
+		byte_stream::write_fixed<uint8_t>(output, data.valid());
+		byte_stream::write_fixed<int32_t>(output, data.get_position().x());
+		byte_stream::write_fixed<int32_t>(output, data.get_position().y());
+		byte_stream::write_fixed<uint8_t>(output, data.get_piece().get_kind());
+		byte_stream::write_fixed<uint8_t>(output, data.get_piece().get_rotation());
+	}
+
+	bool load_piece(byte_stream::reader& input, tetromino_data& data)
+	{
+		const auto valid = input.read_fixed<uint8_t>();
+		const auto x = input.read_fixed<int32_t>();
+		const auto y = input.read_fixed<int32_t>();
+		const auto kind = input.read_fixed<uint8_t>();
+		const auto rotation = input.read_fixed<uint8_t>();
+
+		if (kind >= tetromino_count || rotation >= tetromino_table::rotation_count)
+			return false;
+
+		data = valid ? tetromino_data(screen_vector(x, y), tetromino(static_cast<tetromino_kind>(kind), rotation)) : tetromino_data();
+		return true;
+	}
+}
+
+void tetris_engine::save_state(std::vector<uint8_t>& output)
+{
+	byte_stream::write_fixed<int32_t>(output, this->get_border_width());
+	byte_stream::write_fixed<int32_t>(output, this->get_border_height());
+	byte_stream::write_fixed<uint32_t>(output, this->gravity_ticks);
+	byte_stream::write_fixed<uint64_t>(output, this->get_tick());
+	byte_stream::write_fixed<uint32_t>(output, this->ticks_until_gravity);
+	byte_stream::write_fixed<uint8_t>(output, this->is_game_over());
+	byte_stream::write_fixed<uint8_t>(output, this->get_switched_piece());
+	byte_stream::write_fixed<uint32_t>(output, this->get_score());
+	byte_stream::write_fixed<uint64_t>(output, this->get_seed());
+
+	save_piece(output, this->get_current_piece());
+	save_piece(output, this->get_next_piece());
+	save_piece(output, this->get_saved_piece());
+
+	for (auto word : this->pieces.get_generator().get_state())
+		byte_stream::write_fixed<uint64_t>(output, word);
+	for (auto kind : this->pieces.get_bag())
+		byte_stream::write_fixed<uint8_t>(output, kind);
+	byte_stream::write_fixed<uint8_t>(output, this->pieces.get_index());
+
+	// ONE BYTE PER CELL, 0 IS EMPTY, OTHERWISE COLOR + 1
+	for (size_t y = 0; y < this->get_solid_pieces().get_row_count(); y++)
+	{
+		for (auto& part : this->get_solid_pieces().get_row(y))
+			byte_stream::write_fixed<uint8_t>(output, part.is_valid() ? part.get_color() + 1 : 0);
+	}
+}
+
+bool tetris_engine::load_state(const uint8_t* data, const size_t size)
+{
+	auto input = byte_stream::reader(data, data + size);
+
+	const auto width = input.read_fixed<int32_t>();
+	const auto height = input.read_fixed<int32_t>();
+	if (width != this->get_border_width() || height != this->get_border_height())
+		return false;
+
+	this->gravity_ticks = input.read_fixed<uint32_t>();
+	this->get_tick() = input.read_fixed<uint64_t>();
+	this->ticks_until_gravity = input.read_fixed<uint32_t>();
+	this->is_game_over() = input.read_fixed<uint8_t>() != 0;
+	this->get_switched_piece() = input.read_fixed<uint8_t>() != 0;
+	this->get_score() = input.read_fixed<uint32_t>();
+	this->get_seed() = input.read_fixed<uint64_t>();
+
+	if (!load_piece(input, this->get_current_piece()) ||
+		!load_piece(input, this->get_next_piece()) ||
+		!load_piece(input, this->get_saved_piece()))
+		return false;
+
+	for (auto& word : this->pieces.get_generator().get_state())
+		word = input.read_fixed<uint64_t>();
+	for (auto& kind : this->pieces.get_bag())
+	{
+		kind = static_cast<tetromino_kind>(input.read_fixed<uint8_t>());
+		if (kind >= tetromino_count)
+			return false;
+	}
+	this->pieces.get_index() = input.read_fixed<uint8_t>();
+	if (this->pieces.get_index() > tetromino_count)
+		return false;
+
+	// SOLID PARTS, bitboard ONLY HOLDS THE INSIDE OF THE BORDER
+	this->get_board() = bitboard(width, height);
+	for (size_t y = 0; y < this->get_solid_pieces().get_row_count(); y++)
+	{
+		auto row = this->get_solid_pieces().get_row(y);
+		for (size_t x = 0; x < row.size(); x++)
+		{
+			const auto cell = input.read_fixed<uint8_t>();
+
+			row[x].is_valid() = cell != 0;
+			row[x].get_color() = cell != 0 ? cell - 1 : 0;
+
+			if (row[x].is_valid())
+				this->get_board().set(static_cast<int32_t>(x), static_cast<int32_t>(y));
+		}
+	}
+
+	return !input.failed;
+}
+
+screen_vector tetris_engine::get_drop_position()
+{
+	auto position_copy = this->get_current_piece().get_position();
+	position_copy.y() += this->get_drop_distance(this->get_current_piece().get_piece(), position_copy);
+
+	return position_copy;
+}
+
+int32_t tetris_engine::get_drop_distance(const tetromino& piece, screen_vector position)
+{
+	// EVERY CELL ABOVE ITS COLUMN TOP FALLS FREELY UNTIL IT RESTS ON IT, THE CLOSEST ONE DECIDES
+	auto distance = INT32_MAX;
+	auto above_skyline = true;
+	for (auto part : piece.get_elements())
+	{
+		const auto x = position.x() + part.x();
+		const auto y = position.y() + part.y();
+		const auto top = this->get_board().get_column_top(x);
+
+		if (y >= top)
+		{
+			above_skyline = false;
+			break;
+		}
+
+		distance = std::min(distance, top - 1 - y);
+	}
+
+	if (above_skyline)
+		return distance;
+
+	// UNDER AN OVERHANG THE COLUMN TOP SAYS NOTHING, FALL ONE ROW AT A TIME
+	auto piece_copy = piece;
+	distance = 0;
+	do
+	{
+		++position.y();
+		++distance;
+	} while (!this->does_element_collide(piece_copy, position));
+
+	return distance - 1;
+}
+
+tetromino tetris_engine::get_random_tetromino()
+{
+	return tetromino(this->pieces.next());
+}
+
+screen_vector tetris_engine::get_start_position()
+{
+	return screen_vector{ this->get_border_width() / 2, 1 };
+}
+
+uint32_t tetris_engine::handle_full_lines(tetromino& piece, screen_vector& position)
+{
+	// ONLY THE ROWS THE LOCKED PIECE TOUCHED CAN HAVE BECOME FULL, AT MOST FOUR
+	auto first_row = INT32_MAX;
+	auto last_row = INT32_MIN;
+	for (auto part : piece.get_elements())
+	{
+		first_row = std::min<int32_t>(first_row, position.y() + part.y());
+		last_row = std::max<int32_t>(last_row, position.y() + part.y());
+	}
+
+	// CHECK IF ROW IS COMPLETE, BORDER BITS ARE ALWAYS SET SO COMPARE WITH A FULL ROW
+	std::array<int32_t, 4> full_rows;
+	int32_t lines_cleared = 0;
+	for (auto y = first_row; y <= last_row; y++)
+	{
+		if (this->get_board().is_row_full(y))
+			full_rows[lines_cleared++] = y;
+	}
+
+	if (lines_cleared == 0)
+		return 0;
+
+	// ROWS ABOVE MOVE DOWN ONCE FOR ALL CLEARED LINES, SOLID PIECES ONLY MOVE ROW INDICES
+	// ROWS ABOVE THE STACK ARE EMPTY, NEITHER HAS TO TOUCH THEM
+	const auto stack_top = this->get_board().get_stack_top();
+	this->get_board().erase_rows(full_rows.data(), lines_cleared);
+	this->get_solid_pieces().erase_rows(full_rows.data(), lines_cleared, stack_top, solid_piece());
+
+	// ONE POINT PER LINE
+	this->score += lines_cleared;
+
+	return static_cast<uint32_t>(lines_cleared);
+}
+
+bool tetris_engine::handle_moving_tetromino(const uint8_t input, const bool should_move_piece, bool& add_new_piece, uint32_t& lines_cleared)
+{
+	// MOVE TETROMINO IF PLAYER TELLS TO
+	this->handle_controls(input, this->get_current_piece(), add_new_piece);
+
+	// HOLDING A PIECE CAN END THE GAME
+	if (this->is_game_over())
+		return false;
+
+	// MOVE TETROMINO DOWN ONCE EVERY x TICKS
+	if (should_move_piece)
+		this->move_piece(this->get_current_piece(), add_new_piece);
+
+	// ADD NEW PIECE WHEN CURRENT HAS BEEN LOCKED IN PLACE
+	if (add_new_piece)
+	{
+		// LOCK MOVING PIECE IN PLACE
+		this->add_solid_parts(this->get_current_piece().get_piece(), this->get_current_piece().get_position());
+		lines_cleared = this->handle_full_lines(this->get_current_piece().get_piece(), this->get_current_piece().get_position());
+
+		// IF NEW PIECE COLLIDES, GAME OVER
+		if (this->does_element_collide(this->get_next_piece().get_piece(), this->get_next_piece().get_position()))
+			return false;
+
+		// SET CURRENT PIECE TO NEXT PIECE
+		this->get_current_piece() = this->get_next_piece();
+
+		// GENERATE NEXT PIECE
+		this->get_next_piece() = this->generate_tetromino();
+
+		// RESET SWITCH BLOCK
+		this->get_switched_piece() = false;
+	}
+
+	return true;
+}
+
+void tetris_engine::add_solid_parts(tetromino& piece, screen_vector& position)
+{
+	for (auto part : piece.get_elements())
+	{
+		auto& element = this->get_solid_pieces().get_element(position.y() + part.y(), position.x() + part.x());
+		element.get_color() = piece.get_color();
+		element.is_valid() = true;
+
+		this->get_board().set(position.x() + part.x(), position.y() + part.y());
+	}
+}
+
+void tetris_engine::handle_controls(const uint8_t input, tetromino_data& data, bool& add_new_piece)
+{
+	// NOTHING PRESSED, MOST TICKS
+	if (input == input_none)
+		return;
+
+	auto position_copy = data.get_position();
+
+	// BUILT ONCE AT COMPILE TIME, SORTED BY BIT SO HANDLERS RUN IN THE SAME ORDER AS BEFORE
+	// TO ADD AN ACTION, ADD A BIT TO input_action AND AN ENTRY HERE
+	static constexpr std::array<action_handler, 6> action_handlers = { {
+		{
+			// MOVE DOWN UNTIL COLLISION OCCURS
+			input_hard_drop,
+			[](tetris_engine* instance, tetromino_data& data, screen_vector vector_copy, bool& add_new_piece)
+			{
+				data.get_position().y() += instance->get_drop_distance(data.get_piece(), vector_copy);
+
+				add_new_piece = true;
+			}
+		},
+		{
+			// MOVE LEFT
+			input_left,
+			[](tetris_engine* instance, tetromino_data& data, screen_vector vector_copy, bool&)
+			{
+				--vector_copy.x();
+				if (!instance->does_element_collide(data.get_piece(), vector_copy))
+					--data.get_position().x();
+			}
+		},
+		{
+			// ROTATE 90 DEGREES CLOCKWISE
+			input_rotate,
+			[](tetris_engine* instance, tetromino_data& data, screen_vector, bool&)
+			{
+				auto new_piece = data.get_piece().rotate();
+
+				if (!instance->does_element_collide(new_piece, data.get_position()))
+					data.get_piece() = new_piece;
+			}
+		},
+		{
+			// MOVE RIGHT
+			input_right,
+			[](tetris_engine* instance, tetromino_data& data, screen_vector vector_copy, bool&)
+			{
+				++vector_copy.x();
+				if (!instance->does_element_collide(data.get_piece(), vector_copy))
+					++data.get_position().x();
+			}
+		},
+		{
+			// MOVE DOWN
+			input_down,
+			[](tetris_engine* instance, tetromino_data& data, screen_vector vector_copy, bool&)
+			{
+				++vector_copy.y();
+				if (!instance->does_element_collide(data.get_piece(), vector_copy))
+					++data.get_position().y();
+			}
+		},
+		{
+			input_hold,
+			[](tetris_engine* instance, tetromino_data&, screen_vector, bool&)
+			{
+				if (instance->get_switched_piece())
+					return;
+
+				// INITIATE SWITCH BLOCK
+				instance->get_switched_piece() = true;
+
+				// SWITCH PLACE WITH AN ALREADY SAVED PIECE?
+				const auto switch_with_save = instance->get_saved_piece().valid();
+				const auto saved_piece_copy = instance->get_saved_piece();
+
+				// SAVE CURRENT PIECE
+				instance->get_saved_piece() = instance->get_current_piece();
+				instance->get_saved_piece().get_position() = instance->get_start_position();
+
+				// IF SAVED PIECE WAS NOT NULL, SWITCH PLACE
+				if (switch_with_save)
+				{
+					instance->get_current_piece() = saved_piece_copy;
+				}
+				else
+				{
+					instance->get_current_piece() = instance->get_next_piece();
+					instance->get_next_piece() = instance->generate_tetromino();
+				}
+
+				// IF SAVED CHARACTER WAS ROTATED, IT MIGHT COLLIDE WITH BORDER
+				// MOVE DOWN IF IT COLLIDES, IF IT FITS NOWHERE THE GAME IS OVER
+				while (true)
+				{
+					if (!instance->does_element_collide(instance->get_current_piece().get_piece(), instance->get_current_piece().get_position()))
+						break;
+
+					if (++instance->get_current_piece().get_position().y() >= instance->get_border_height())
+					{
+						instance->is_game_over() = true;
+						return;
+					}
+				}
+			}
+		}
+	} };
+
+	// ITERATE LIST OF HANDLERS AND INVOKE WHEN RESPECTIVE ACTION IS SET
+	for (auto[action, handler_fn] : action_handlers)
+	{
+		if (input & action)
+			handler_fn(this, data, position_copy, add_new_piece);
+	}
+}
+
+void tetris_engine::move_piece(tetromino_data& data, bool& add_new_piece)
+{
+	// MOVE TETROMINO DOWN ONCE TO CHECK FOR COLLISION
+	auto copy_position = data.get_position();
+	++copy_position.y();
+
+	// IF ANY FUTURE BLOCK COLLIDES, LOCK TETROMINO IN PLACE
+	if (!this->does_element_collide(data.get_piece(), copy_position))
+	{
+		++data.get_position().y();
+	}
+	else
+	{
+		// LOCK TETROMINO IN PLACE
+		add_new_piece = true;
+	}
+}
+
+bool tetris_engine::does_element_collide(tetromino& piece, screen_vector position)
+{
+	// COLLIDED WITH A SOLID PIECE OR BORDER? BORDER IS PART OF THE BITBOARD
+	// SO EACH ROW OF THE PIECE IS A SINGLE AND, ANY COLLISION SHALL HALT MOVEMENT
+	return this->get_board().collides(piece.get_rows(), position.x(), position.y());
+}
+
+tetromino_data tetris_engine::generate_tetromino()
+{
+	return tetromino_data(this->get_start_position(), this->get_random_tetromino());
+}
+
+
+// GETTERS/SETTERS
+
+tetromino_data& tetris_engine::get_current_piece()
+{
+	return this->current_piece;
+}
+
+tetromino_data& tetris_engine::get_next_piece()
+{
+	return this->next_piece;
+}
+
+tetromino_data& tetris_engine::get_saved_piece()
+{
+	return this->saved_piece;
+}
+
+bool& tetris_engine::get_switched_piece()
+{
+	return this->has_switched_piece;
+}
+
+uint32_t& tetris_engine::get_score()
+{
+	return this->score;
+}
+
+uint64_t& tetris_engine::get_tick()
+{
+	return this->tick;
+}
+
+uint64_t& tetris_engine::get_seed()
+{
+	return this->seed;
+}
+
+bool& tetris_engine::is_game_over()
+{
+	return this->game_over;
+}
+
+int32_t& tetris_engine::get_border_width()
+{
+	return this->border_width;
+}
+
+int32_t& tetris_engine::get_border_height()
+{
+	return this->border_height;
+}
+
+uint32_t& tetris_engine::get_ticks_until_gravity()
+{
+	return this->ticks_until_gravity;
+}
+
+uint32_t& tetris_engine::get_gravity_ticks()
+{
+	return this->gravity_ticks;
+}
+
+indexed_array2d<solid_piece>& tetris_engine::get_solid_pieces()
+{
+	return this->solid_pieces;
+}
+
+bitboard& tetris_engine::get_board()
+{
+	return this->board;
+}
@@ -0,0 +1,148 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "array2d.hpp"
+#include "bitboard.hpp"
+#include "byte_stream.hpp"
+#include "console_color.hpp"
+#include "indexed_array2d.hpp"
+#include "screen_vector.hpp"
+#include "solid_piece.hpp"
+#include "tetromino.hpp"
+#include "tetromino_data.hpp"
+#include "piece_bag.hpp"
+#include "rng.hpp"
+
+// ACTIONS TAKEN DURING A SINGLE TICK, COMBINED INTO A BITMASK
+// HANDLERS RUN IN ASCENDING BIT ORDER
+enum input_action : uint8_t
+{
+	input_none = 0,
+	input_hard_drop = 1 << 0,
+	input_left = 1 << 1,
+	input_rotate = 1 << 2,
+	input_right = 1 << 3,
+	input_down = 1 << 4,
+	input_hold = 1 << 5
+};
+
+// EVENTS THAT HAPPENED DURING A SINGLE TICK
+struct step_result
+{
+	bool locked;
+
+	// LINES THE LOCK CLEARED AT ONCE, 0 ON TICKS WITHOUT A LOCK
+	uint32_t lines_cleared;
+	bool game_over;
+};
+
+// ONE ENTRY PER input_action, SEE tetris_engine::handle_controls
+struct action_handler
+{
+	uint8_t action;
+	void(*handler)(class tetris_engine*, tetromino_data&, screen_vector, bool&);
+};
+
+// GAME LOGIC WITHOUT ANY CONSOLE, CLOCK OR OPERATING SYSTEM DEPENDENCY
+// TIME ONLY ADVANCES WHEN step IS CALLED, SO IT CAN RUN AS FAST AS THE CPU ALLOWS
+class tetris_engine
+{
+public:
+	// 60 TICKS PER SECOND, PIECE FALLS ONE ROW EVERY 15 TICKS (250 MS)
+	static constexpr uint32_t ticks_per_second = 60;
+	static constexpr uint32_t default_gravity_ticks = 15;
+
+	// THE SAME SEED PRODUCES THE SAME SEQUENCE OF PIECES
+	tetris_engine(int32_t width, int32_t height, uint64_t seed = rng::get_random_seed(), uint32_t gravity_ticks = default_gravity_ticks);
+
+	// SET PIECES BEFORE FIRST TICK
+	void start();
+
+	// ADVANCE GAME BY ONE TICK, input IS A BITMASK OF input_action
+	step_result step(const uint8_t input);
+
+	// SNAPSHOT OF THE WHOLE GAME, bitboard IS REBUILT FROM solid_pieces ON LOAD
+	// load_state FAILS IF THE SNAPSHOT IS TRUNCATED OR FROM A BOARD OF ANOTHER SIZE
+	void save_state(std::vector<uint8_t>& output);
+	bool load_state(const uint8_t* data, const size_t size);
+
+	// WHERE current_piece WOULD LAND IF DROPPED
+	screen_vector get_drop_position();
+
+	// ROWS piece AT position CAN FALL BEFORE IT LANDS
+	// READ FROM THE COLUMN TOPS OF THE BOARD, ONLY A PIECE TUCKED UNDER AN OVERHANG FALLS ROW BY ROW
+	int32_t get_drop_distance(const tetromino& piece, screen_vector position);
+
+	// WHERE NEW AND HELD PIECES APPEAR
+	screen_vector get_start_position();
+
+	// GAME DATA
+	tetromino_data& get_current_piece();
+	tetromino_data& get_next_piece();
+	tetromino_data& get_saved_piece();
+	bool& get_switched_piece();
+	uint32_t& get_score();
+	uint64_t& get_tick();
+	uint64_t& get_seed();
+	bool& is_game_over();
+
+	// GAME SETTINGS
+	int32_t& get_border_width();
+	int32_t& get_border_height();
+	uint32_t& get_gravity_ticks();
+
+	// TICKS LEFT UNTIL GRAVITY MOVES THE PIECE, ON THE LAST ONE IT DOES
+	// NOTHING ELSE HAPPENS ON TICKS WITHOUT INPUT, SO THIS IS WHEN THE GAME NEXT CHANGES BY ITSELF
+	uint32_t& get_ticks_until_gravity();
+
+	// ENTITIES
+	indexed_array2d<solid_piece>& get_solid_pieces();
+	bitboard& get_board();
+
+private:
+	tetromino get_random_tetromino();
+	tetromino_data generate_tetromino();
+
+	// GAME
+	// CLEARS THE FULL ROWS AMONG THOSE piece COVERS AT position, RETURNS HOW MANY
+	uint32_t handle_full_lines(tetromino& piece, screen_vector& position);
+	bool handle_moving_tetromino(const uint8_t input, const bool should_move_piece, bool& add_new_piece, uint32_t& lines_cleared);
+	void add_solid_parts(tetromino& piece, screen_vector& position);
+	void handle_controls(const uint8_t input, tetromino_data& data, bool& add_new_piece);
+	void move_piece(tetromino_data& data, bool& add_new_piece);
+
+	// GAME DATA
+	tetromino_data current_piece;
+	tetromino_data next_piece;
+	tetromino_data saved_piece;
+
+	// CURRENT PIECE CAME FROM HOLD, IT CAN'T BE HELD AGAIN UNTIL IT LOCKS
+	bool has_switched_piece;
+
+	// COLLISION
+	bool does_element_collide(tetromino& piece, screen_vector position);
+
+	// GAME SETTINGS
+	int32_t border_width;
+	int32_t border_height;
+	uint32_t gravity_ticks;
+
+	// TIMING
+	uint64_t tick;
+	uint32_t ticks_until_gravity;
+	bool game_over;
+
+	// PIECE SEQUENCE
+	uint64_t seed;
+	piece_bag pieces;
+
+	// SCOREBOARD
+	uint32_t score;
+
+	// ENTITIES
+	indexed_array2d<solid_piece> solid_pieces;
+
+	// OCCUPANCY OF solid_pieces INCLUDING BORDER, USED FOR COLLISION AND LINE CLEARS
+	bitboard board;
+};
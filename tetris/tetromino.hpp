@@ -1,58 +1,239 @@
 #pragma once
 
-#define _USE_MATH_DEFINES
-#include <math.h>
-#include <initializer_list>
-#include <vector>
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include "console_color.hpp"
 #include "screen_vector.hpp"
 
+enum tetromino_kind : uint8_t
+{
+	tetromino_i,
+	tetromino_j,
+	tetromino_l,
+	tetromino_o,
+	tetromino_t,
+	tetromino_z,
+	tetromino_s,
+	tetromino_count
+};
+
+using tetromino_cells = std::array<screen_vector, 4>;
+
+namespace tetromino_table
+{
+	constexpr size_t rotation_count = 4;
+
+	// https://en.wikipedia.org/wiki/Tetris#Tetromino_colors
+	constexpr std::array<uint8_t, tetromino_count> colors =
+	{
+		console_color::green,
+		console_color::cyan,
+		console_color::red,
+		console_color::pink,
+		console_color::yellow,
+		console_color::white,
+		console_color::dark_green
+	};
+
+	// CELLS OF EVERY PIECE BEFORE ROTATION, RELATIVE TO ITS POSITION
+	constexpr std::array<std::array<int16_t, 8>, tetromino_count> shapes =
+	{ {
+		/*
+		I TETROMINO
+		#
+		#
+		#
+		#
+		*/
+		{ 0, 0, 0, 1, 0, 2, 0, 3 },
+
+		/*
+		J TETROMINO
+		###
+		  #
+		*/
+		{ 0, 0, 1, 0, 2, 0, 2, 1 },
+
+		/*
+		L TETROMINO
+		###
+		#
+		*/
+		{ -1, 0, 0, 0, 1, 0, -1, 1 },
+
+		/*
+		O TETROMINO
+		##
+		##
+		*/
+		{ 0, 0, 1, 0, 0, 1, 1, 1 },
+
+		/*
+		T TETROMINO
+		###
+		 #
+		*/
+		{ 0, 0, -1, 0, 1, 0, 0, 1 },
+
+		/*
+		Z TETROMINO
+		##
+		 ##
+		*/
+		{ 0, 0, -1, 0, 0, 1, 1, 1 },
+
+		/*
+		S TETROMINO
+		 ##
+		##
+		*/
+		{ 0, 0, 1, 0, -1, 1, 0, 1 }
+	} };
 
+	// EVERY ROTATION OF EVERY PIECE, BUILT AT COMPILE TIME
+	constexpr auto build_rotations()
+	{
+		std::array<std::array<tetromino_cells, rotation_count>, tetromino_count> result{};
+
+		for (size_t kind = 0; kind < tetromino_count; kind++)
+		{
+			for (size_t part = 0; part < 4; part++)
+			{
+				auto x = shapes[kind][part * 2];
+				auto y = shapes[kind][part * 2 + 1];
+
+				for (size_t rotation = 0; rotation < rotation_count; rotation++)
+				{
+					result[kind][rotation][part] = screen_vector(x, y);
+
+					// ROTATING A 2D VECTOR CLOCK-WISE
+					// IS SIMPLE: (y, -x)
+					// IN THIS CASE Y COORDINATE IS MIRRORED DUE TO
+					// SCREEN BUFFER STARTING FROM TOP-LEFT (READ CRT WIKIPEDIA)
+					// SO CLOCKWISE ROTATION IS (-y, x)
+					const auto old_x = x;
+					x = -y;
+					y = old_x;
+				}
+			}
+		}
+
+		return result;
+	}
+
+	constexpr auto rotations = build_rotations();
+
+	// EVERY ROTATION OF EVERY PIECE AS ONE BIT MASK PER ROW IT COVERS, FOR bitboard::collides
+	// BIT i OF masks[r] IS THE CELL (left + i, top + r) RELATIVE TO THE PIECE POSITION
+	struct row_masks
+	{
+		int16_t left;
+		int16_t top;
+		int16_t width;
+		int16_t row_count;
+		std::array<uint8_t, 4> masks;
+	};
+
+	constexpr auto build_row_masks()
+	{
+		std::array<std::array<row_masks, rotation_count>, tetromino_count> result{};
+
+		for (size_t kind = 0; kind < tetromino_count; kind++)
+		{
+			std::array<int16_t, 8> cells = shapes[kind];
+			for (size_t rotation = 0; rotation < rotation_count; rotation++)
+			{
+				int16_t left = cells[0], right = cells[0], top = cells[1], bottom = cells[1];
+				for (size_t part = 1; part < 4; part++)
+				{
+					left = std::min(left, cells[part * 2]);
+					right = std::max(right, cells[part * 2]);
+					top = std::min(top, cells[part * 2 + 1]);
+					bottom = std::max(bottom, cells[part * 2 + 1]);
+				}
+
+				auto& rows = result[kind][rotation];
+				rows.left = left;
+				rows.top = top;
+				rows.width = static_cast<int16_t>(right - left + 1);
+				rows.row_count = static_cast<int16_t>(bottom - top + 1);
+				for (size_t part = 0; part < 4; part++)
+					rows.masks[cells[part * 2 + 1] - top] |= static_cast<uint8_t>(1 << (cells[part * 2] - left));
+
+				// SAME CLOCK-WISE ROTATION AS build_rotations
+				for (size_t part = 0; part < 4; part++)
+				{
+					const auto old_x = cells[part * 2];
+					cells[part * 2] = static_cast<int16_t>(-cells[part * 2 + 1]);
+					cells[part * 2 + 1] = old_x;
+				}
+			}
+		}
+
+		return result;
+	}
+
+	constexpr auto piece_rows = build_row_masks();
+}
+
+// A PIECE IS ONLY ITS KIND AND ROTATION, CELLS ARE LOOKED UP IN tetromino_table
 struct tetromino
 {
 	tetromino() = default;
-	tetromino(const uint8_t new_color_code, const std::initializer_list<screen_vector> args) : elements(args), color_code(new_color_code) {}
+	constexpr tetromino(const tetromino_kind new_kind, const uint8_t new_rotation = 0) : kind(new_kind), rotation(new_rotation) {}
 
-	inline auto operator[] (const size_t index) -> screen_vector&
+	inline auto operator[] (const size_t index) const -> const screen_vector&
 	{
-		return this->elements[index];
+		return this->get_elements()[index];
 	}
 
-	inline auto get_elements() -> std::vector<screen_vector>&
+	inline auto get_elements() const -> const tetromino_cells&
 	{
-		return this->elements;
+		return tetromino_table::rotations[this->kind][this->rotation];
 	}
-	
-	inline constexpr auto get_color() -> const uint8_t
+
+	inline auto get_rows() const -> const tetromino_table::row_masks&
 	{
-		return this->color_code;
+		return tetromino_table::piece_rows[this->kind][this->rotation];
 	}
-	
-	inline auto get_size() -> const size_t
+
+	inline constexpr auto get_color() const -> uint8_t
 	{
-		return this->elements.size();
+		return tetromino_table::colors[this->kind];
 	}
 
-	inline auto rotate() -> tetromino
+	inline constexpr auto get_size() const -> size_t
 	{
-		auto copy = *this;
+		return tetromino_cells().size();
+	}
 
-		for (auto& part : copy.get_elements())
-		{
-			// ROTATING A 2D VECTOR CLOCK-WISE 
-			// IS SIMPLE: (y, -x)
-			// IN THIS CASE Y COORDINATE IS MIRRORED DUE TO 
-			// SCREEN BUFFER STARTING FROM TOP-LEFT (READ CRT WIKIPEDIA)
-			// SO CLOCKWISE ROTATION IS (-y, x)
-			const auto old_x = part.x();
-			part.x() = -part.y();
-			part.y() = old_x;
-		}
+	inline constexpr auto get_kind() const -> tetromino_kind
+	{
+		return this->kind;
+	}
+
+	inline constexpr auto get_rotation() const -> uint8_t
+	{
+		return this->rotation;
+	}
 
-		return copy;
+	inline constexpr bool operator==(const tetromino& other) const
+	{
+		return this->kind == other.kind && this->rotation == other.rotation;
+	}
+	inline constexpr bool operator!=(const tetromino& other) const
+	{
+		return !(*this == other);
+	}
+
+	inline constexpr auto rotate() const -> tetromino
+	{
+		return tetromino(this->kind, static_cast<uint8_t>((this->rotation + 1) % tetromino_table::rotation_count));
 	}
 
 private:
-	std::vector<screen_vector> elements;
-	uint8_t color_code;
+	tetromino_kind kind = tetromino_i;
+	uint8_t rotation = 0;
 };
\ No newline at end of file
@@ -13,7 +13,7 @@ struct tetromino_data
 	bool valid();
 
 private:
-	bool is_valid;
+	bool is_valid = false;
 	screen_vector position;
 	tetromino piece;
 };
\ No newline at end of file
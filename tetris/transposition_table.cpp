@@ -0,0 +1,81 @@
+#include "transposition_table.hpp"
+#include <chrono>
+#include <cstring>
+#include "zobrist.hpp"
+
+transposition_table::transposition_table(const uint64_t entry_count) : entries(), mask(0)
+{
+	uint64_t size = 1;
+	while (size < entry_count)
+		size <<= 1;
+
+	this->entries.reset(new entry[size]);
+	this->mask = size - 1;
+	this->clear();
+}
+
+uint64_t transposition_table::make_key(const uint64_t board_hash, const bool has_piece, const tetromino piece, const bool has_held, const tetromino held, const bool can_hold)
+{
+	// LAST KEY OF EACH TABLE STANDS FOR "NO PIECE"
+	auto key = board_hash;
+	key ^= zobrist::piece_keys[has_piece ? piece.get_kind() : tetromino_count];
+	key ^= zobrist::held_keys[has_held ? held.get_kind() : tetromino_count];
+	if (can_hold)
+		key ^= zobrist::can_hold_key;
+
+	return key;
+}
+
+bool transposition_table::probe(const uint64_t key, float& score, transposition_statistics& statistics)
+{
+	const auto timed = (statistics.probes++ % sample_interval) == 0;
+	const auto start_time = timed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
+	auto& slot = this->entries[key & this->mask];
+	const auto data = slot.data.load(std::memory_order_relaxed);
+	const auto check = slot.check.load(std::memory_order_relaxed);
+	const auto hit = (check ^ data) == key;
+
+	if (hit)
+	{
+		const auto bits = static_cast<uint32_t>(data);
+		std::memcpy(&score, &bits, sizeof(score));
+		++statistics.hits;
+	}
+
+	if (timed)
+	{
+		++statistics.sampled_probes;
+		statistics.sampled_nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+	}
+
+	return hit;
+}
+
+void transposition_table::store(const uint64_t key, const float score, transposition_statistics& statistics)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &score, sizeof(bits));
+
+	const uint64_t data = bits;
+
+	auto& slot = this->entries[key & this->mask];
+	slot.check.store(key ^ data, std::memory_order_relaxed);
+	slot.data.store(data, std::memory_order_relaxed);
+	++statistics.stores;
+}
+
+void transposition_table::clear()
+{
+	// AN EMPTY SLOT ONLY MATCHES KEY ~0
+	for (uint64_t index = 0; index <= this->mask; index++)
+	{
+		this->entries[index].check.store(~uint64_t(0), std::memory_order_relaxed);
+		this->entries[index].data.store(0, std::memory_order_relaxed);
+	}
+}
+
+auto transposition_table::get_entry_count() -> uint64_t
+{
+	return this->mask + 1;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "tetromino.hpp"
+
+// COUNTERS OF ONE SEARCH THREAD, KEPT BY THE CALLER SO THREADS SHARING A TABLE DON'T SHARE COUNTER LINES
+struct transposition_statistics
+{
+	uint64_t probes = 0;
+	uint64_t hits = 0;
+	uint64_t stores = 0;
+
+	// EVERY sample_interval-TH PROBE IS TIMED, TIMING ALL OF THEM WOULD COST MORE THAN THE PROBE
+	uint64_t sampled_probes = 0;
+	uint64_t sampled_nanoseconds = 0;
+};
+
+// FIXED-SIZE HASH TABLE OF BOARD EVALUATIONS SHARED BY SEARCH THREADS WITHOUT LOCKS
+// AN ENTRY IS TWO WORDS, check = key ^ data, WRITTEN AND READ WITH RELAXED ATOMICS
+// A READER THAT SEES HALF OF ONE STORE AND HALF OF ANOTHER GETS A check THAT DOESN'T MATCH ITS KEY
+// AND TREATS IT AS A MISS, SO TORN ENTRIES ARE NEVER RETURNED
+// ONE ENTRY PER SLOT, A NEW STORE ALWAYS REPLACES THE OLD ONE
+class transposition_table
+{
+public:
+	static constexpr uint64_t sample_interval = 64;
+
+	// entry_count IS ROUNDED UP TO A POWER OF TWO, 16 BYTES EACH
+	transposition_table(const uint64_t entry_count = uint64_t(1) << 20);
+
+	// KEY OF A SEARCH STATE: BOARD, PIECE TO PLACE NEXT AND WHAT THE HOLD LOOKS LIKE
+	// has_piece AND has_held ARE FALSE WHEN THERE IS NO SUCH PIECE
+	static uint64_t make_key(const uint64_t board_hash, const bool has_piece, const tetromino piece, const bool has_held, const tetromino held, const bool can_hold);
+
+	bool probe(const uint64_t key, float& score, transposition_statistics& statistics);
+	void store(const uint64_t key, const float score, transposition_statistics& statistics);
+
+	// FORGET EVERYTHING, NOT SAFE WHILE OTHER THREADS USE THE TABLE
+	void clear();
+
+	auto get_entry_count() -> uint64_t;
+
+private:
+	struct entry
+	{
+		std::atomic<uint64_t> check;
+		std::atomic<uint64_t> data;
+	};
+
+	std::unique_ptr<entry[]> entries;
+	uint64_t mask;
+};
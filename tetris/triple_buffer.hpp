@@ -0,0 +1,60 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// HANDS THE NEWEST VALUE FROM ONE WRITER THREAD TO ONE READER THREAD WITHOUT LOCKS OR COPIES
+// THE WRITER FILLS THE BACK SLOT AND SWAPS IT WITH THE MIDDLE ONE, THE READER SWAPS THE MIDDLE ONE
+// WITH ITS FRONT SLOT WHEN IT IS FRESH. NEITHER SIDE EVER WAITS, A SLOW READER ONLY SKIPS VALUES
+template <typename T>
+class triple_buffer
+{
+public:
+	// WRITER: SLOT TO FILL, THE READER DOESN'T SEE IT UNTIL publish
+	T& get_back()
+	{
+		return this->slots[this->back];
+	}
+
+	// WRITER: MAKE THE BACK SLOT THE NEWEST VALUE, FALSE IF THE ONE IT REPLACES WAS NEVER READ
+	bool publish()
+	{
+		const auto previous = this->middle.exchange(static_cast<uint8_t>(this->back | fresh_bit), std::memory_order_acq_rel);
+		this->back = previous & index_mask;
+
+		return (previous & fresh_bit) == 0;
+	}
+
+	// READER: TRUE IF SOMETHING WAS PUBLISHED SINCE THE LAST update
+	bool has_fresh() const
+	{
+		return (this->middle.load(std::memory_order_acquire) & fresh_bit) != 0;
+	}
+
+	// READER: MOVE THE NEWEST PUBLISHED VALUE TO THE FRONT, FALSE IF THERE IS NOTHING NEW
+	bool update()
+	{
+		if (!this->has_fresh())
+			return false;
+
+		this->front = this->middle.exchange(this->front, std::memory_order_acq_rel) & index_mask;
+		return true;
+	}
+
+	// READER: VALUE TAKEN BY THE LAST update, STAYS UNCHANGED UNTIL THE NEXT ONE
+	T& get_front()
+	{
+		return this->slots[this->front];
+	}
+
+private:
+	static constexpr uint8_t index_mask = 0x3;
+	static constexpr uint8_t fresh_bit = 0x4;
+
+	std::array<T, 3> slots{};
+
+	// EACH INDEX ON ITS OWN CACHE LINE, ONLY middle IS SHARED
+	alignas(64) uint8_t back = 0;
+	alignas(64) std::atomic<uint8_t> middle{ 1 };
+	alignas(64) uint8_t front = 2;
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "tetromino.hpp"
+
+// ZOBRIST KEYS OF THE PLAYFIELD AND SEARCH STATE
+// CELL (BIT, Y) HAS KEY column_key(BIT, Y) ROTATED LEFT BY Y, SO A WHOLE ROW MOVING DOWN INSIDE
+// ITS BAND OF 64 LINES IS A SINGLE ROTATION OF ITS XOR-ED KEYS INSTEAD OF A REHASH OF EVERY CELL
+// THE ROTATION REPEATS EVERY 64 LINES, SO EVERY BAND HAS ITS OWN KEYS AND A ROW MOVING INTO
+// ANOTHER BAND IS REKEYED FROM ITS CELLS
+// BITS PAST THE FIRST WORD OF A WIDE ROW HAVE THEIR OWN KEYS TOO, SEE column_key
+namespace zobrist
+{
+	constexpr uint64_t next_key(uint64_t& state)
+	{
+		// SPLITMIX64, SAME AS rng::splitmix64 BUT USABLE AT COMPILE TIME
+		auto result = (state += 0x9E3779B97F4A7C15);
+		result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9;
+		result = (result ^ (result >> 27)) * 0x94D049BB133111EB;
+		return result ^ (result >> 31);
+	}
+
+	template <size_t count>
+	constexpr std::array<uint64_t, count> build_keys(uint64_t seed)
+	{
+		std::array<uint64_t, count> keys{};
+		for (auto& key : keys)
+			key = next_key(seed);
+
+		return keys;
+	}
+
+	constexpr auto column_keys = build_keys<64>(0x7E7215);
+	constexpr auto piece_keys = build_keys<tetromino_count + 1>(0x9E1EC7);
+	constexpr auto held_keys = build_keys<tetromino_count + 1>(0x401D);
+	constexpr uint64_t can_hold_key = 0xC3A5C85C97CB3127;
+
+	inline uint64_t rotate_left(const uint64_t value, const uint32_t shift)
+	{
+		return (value << (shift & 63)) | (value >> ((64 - shift) & 63));
+	}
+
+	// column_keys[bit] FOR THE FIRST 64 BITS OF A ROW IN THE FIRST 64 LINES
+	// LATER WORDS OF A ROW AND LATER BANDS OF 64 LINES TAKE THE SPLITMIX OF THAT KEY, THEIR WORD AND THEIR BAND,
+	// A BIJECTION, SO NO TWO OF THEM SHARE A KEY
+	inline uint64_t column_key(const int32_t bit, const int32_t y)
+	{
+		const auto key = column_keys[bit & 63];
+		const auto word = static_cast<uint32_t>(bit) >> 6;
+		const auto band = static_cast<uint32_t>(y) >> 6;
+		if ((word | band) == 0)
+			return key;
+
+		auto state = key ^ (static_cast<uint64_t>(word) << 32) ^ band;
+		return next_key(state);
+	}
+
+	// ROWS IN THE SAME BAND SHARE column_key
+	inline bool same_band(const int32_t y1, const int32_t y2)
+	{
+		return (y1 >> 6) == (y2 >> 6);
+	}
+
+	inline uint64_t cell_key(const int32_t bit, const int32_t y)
+	{
+		return rotate_left(column_key(bit, y), static_cast<uint32_t>(y));
+	}
+}